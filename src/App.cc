@@ -1,13 +1,37 @@
 
 # include "App.hh"
+# include <sstream>
+# include <iomanip>
 # include <algorithm>
 # include <maths_utils/ComparisonUtils.hh>
 
 /// @brief - Size of the tiles.
 # define TILE_SIZE 170
 
+/// @brief - The number of iterations of the last search of
+/// the AI displayed in the debug layer, starting from the
+/// deepest one.
+# define DEBUG_ITERATIONS 8u
+
 namespace {
 
+  std::string
+  formatFloat(float v, int decimals) noexcept {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(decimals) << v;
+
+    return out.str();
+  }
+
+  std::string
+  formatRate(std::uint64_t count, std::uint64_t total) noexcept {
+    if (total == 0u) {
+      return "-";
+    }
+
+    return formatFloat(100.0f * count / total, 1) + "%";
+  }
+
   int
   spriteIDFromPiece(const chess::Piece& p) noexcept {
     if (p.knight()) {
@@ -142,6 +166,9 @@ namespace chess {
     if (c.keys[pge::controls::keys::P]) {
       m_game->togglePause();
     }
+    if (c.keys[pge::controls::keys::T]) {
+      m_game->toggleTracing();
+    }
   }
 
   void
@@ -241,6 +268,39 @@ namespace chess {
     DrawString(olc::vi2d(0, h / 2 + 1 * dOffset), "World cell coords : " + toString(mtp), olc::CYAN);
     DrawString(olc::vi2d(0, h / 2 + 2 * dOffset), "Intra cell        : " + toString(it), olc::CYAN);
 
+    // Draw the statistics of the last search of the AI.
+    chess::ai::SearchStats ss;
+    if (m_game->getSearchStats(ss)) {
+      int y = h / 2 + 4 * dOffset;
+
+      DrawString(olc::vi2d(0, y), "AI depth          : " + std::to_string(ss.depth) + " in " + formatFloat(ss.time, 1) + "ms", olc::CYAN);
+      y += dOffset;
+      DrawString(olc::vi2d(0, y), "Nodes             : " + std::to_string(ss.nodes) + " (" + formatRate(ss.quiescence, ss.nodes) + " quiescence)", olc::CYAN);
+      y += dOffset;
+      DrawString(olc::vi2d(0, y), "Nodes per second  : " + formatFloat(ss.nps, 0), olc::CYAN);
+      y += dOffset;
+      DrawString(olc::vi2d(0, y), "First move cutoffs: " + formatRate(ss.firstMoveCutoffs, ss.cutoffs), olc::CYAN);
+      y += dOffset;
+      DrawString(olc::vi2d(0, y), "Hash hits         : " + formatRate(ss.hits, ss.probes), olc::CYAN);
+      y += dOffset;
+
+      unsigned first = (ss.iterations.size() > DEBUG_ITERATIONS ? ss.iterations.size() - DEBUG_ITERATIONS : 0u);
+      for (unsigned id = first ; id < ss.iterations.size() ; ++id) {
+        const chess::ai::IterationStats& is = ss.iterations[id];
+
+        std::string depth = std::to_string(is.depth);
+        depth = std::string(depth.size() < 2u ? 2u - depth.size() : 0u, ' ') + depth;
+
+        DrawString(
+          olc::vi2d(0, y),
+          "  Depth " + depth + "        : " + formatFloat(is.time, 1) + "ms, " + std::to_string(is.nodes) +
+          " node(s), branching " + formatFloat(is.branching, 2),
+          olc::CYAN
+        );
+        y += dOffset;
+      }
+    }
+
     SetPixelMode(olc::Pixel::NORMAL);
   }
 
@@ -409,13 +469,13 @@ namespace chess {
       drawRect(sd, res.cf);
 
       // Also, not the possible positions for this piece.
-      CoordinatesSet ps = b.availablePositions(*c);
+      CoordinatesList ps = b.availablePositions(*c);
 
-      for (CoordinatesSet::const_iterator it = ps.cbegin() ; it != ps.cend() ; ++it) {
-        sd.x = 1.0f * it->x();
+      for (unsigned id = 0u ; id < ps.size() ; ++id) {
+        sd.x = 1.0f * ps[id].x();
         // Note that the board is upside down when drawn
         // on screen.
-        sd.y = m_game->getPlayer() == Color::White ? 7.0f - it->y() : it->y();
+        sd.y = m_game->getPlayer() == Color::White ? 7.0f - ps[id].y() : ps[id].y();
 
         sd.sprite.tint = olc::Pixel(0, 0, 255, pge::alpha::AlmostTransparent);
         drawRect(sd, res.cf);
@@ -22,6 +22,7 @@ namespace pge {
 
         N,
         P,
+        T,
 
         KeysCount
       };
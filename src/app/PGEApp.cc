@@ -202,6 +202,9 @@ namespace pge {
     b = GetKey(olc::P);
     m_controls.keys[controls::keys::P] = b.bReleased;
 
+    b = GetKey(olc::T);
+    m_controls.keys[controls::keys::T] = b.bReleased;
+
     b = GetKey(olc::TAB),
     m_controls.tab = b.bReleased;
 
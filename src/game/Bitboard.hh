@@ -0,0 +1,151 @@
+#ifndef    BITBOARD_HH
+# define   BITBOARD_HH
+
+# include <cstdint>
+# include "Color.hh"
+
+namespace chess {
+
+  /// @brief - A set of cells of the board packed in a single
+  /// integer. The cell at `x, y` is represented by the bit at
+  /// index `y * 8 + x`, which matches the `cells::Value`.
+  using Bitboard = std::uint64_t;
+
+  namespace bitboard {
+
+    /**
+     * @brief - Returns a bitboard where only the input cell
+     *          is set.
+     * @param id - the linear index of the cell.
+     * @return - the corresponding bitboard.
+     */
+    constexpr
+    Bitboard
+    cell(int id) noexcept;
+
+    /**
+     * @brief - Returns the number of cells set in the input
+     *          bitboard.
+     * @param b - the bitboard to count.
+     * @return - the number of set cells.
+     */
+    int
+    count(Bitboard b) noexcept;
+
+    /**
+     * @brief - Returns the index of the lowest cell set in
+     *          the bitboard. The input should not be empty.
+     * @param b - the bitboard to scan.
+     * @return - the index of the first set cell.
+     */
+    int
+    first(Bitboard b) noexcept;
+
+    /**
+     * @brief - Returns the index of the highest cell set in
+     *          the bitboard. The input should not be empty.
+     * @param b - the bitboard to scan.
+     * @return - the index of the last set cell.
+     */
+    int
+    last(Bitboard b) noexcept;
+
+    /**
+     * @brief - Returns the index of the lowest cell set in
+     *          the bitboard and removes it from the input.
+     *          The input should not be empty.
+     * @param b - the bitboard to scan and update.
+     * @return - the index of the cell removed.
+     */
+    int
+    pop(Bitboard& b) noexcept;
+
+    /**
+     * @brief - Returns the cells attacked by a knight at the
+     *          input position.
+     * @param id - the linear index of the knight.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    knightAttacks(int id) noexcept;
+
+    /**
+     * @brief - Returns the cells attacked by a king at the
+     *          input position. Castling is not considered.
+     * @param id - the linear index of the king.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    kingAttacks(int id) noexcept;
+
+    /**
+     * @brief - Returns the cells attacked by a pawn of the
+     *          input color at the input position. Only the
+     *          captures are considered.
+     * @param c - the color of the pawn.
+     * @param id - the linear index of the pawn.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    pawnAttacks(const Color& c, int id) noexcept;
+
+    /**
+     * @brief - Returns the cells attacked by a bishop at the
+     *          input position given the occupancy of the
+     *          board. The first blocking piece along each
+     *          diagonal is included in the attacks.
+     * @param id - the linear index of the bishop.
+     * @param occupied - the occupied cells of the board.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    bishopAttacks(int id, Bitboard occupied) noexcept;
+
+    /**
+     * @brief - Similar to `bishopAttacks` but for a rook.
+     * @param id - the linear index of the rook.
+     * @param occupied - the occupied cells of the board.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    rookAttacks(int id, Bitboard occupied) noexcept;
+
+    /**
+     * @brief - Similar to `bishopAttacks` but for a queen.
+     * @param id - the linear index of the queen.
+     * @param occupied - the occupied cells of the board.
+     * @return - the attacked cells.
+     */
+    Bitboard
+    queenAttacks(int id, Bitboard occupied) noexcept;
+
+    /**
+     * @brief - Returns the cells strictly between the two input
+     *          cells in case they are on the same line, column
+     *          or diagonal.
+     * @param from - the linear index of the first cell.
+     * @param to - the linear index of the second cell.
+     * @return - the cells between the two, or an empty bitboard
+     *           if they are not aligned.
+     */
+    Bitboard
+    between(int from, int to) noexcept;
+
+    /**
+     * @brief - Returns the whole line (across the board) going
+     *          through both input cells in case they are on the
+     *          same line, column or diagonal.
+     * @param from - the linear index of the first cell.
+     * @param to - the linear index of the second cell.
+     * @return - the line through both cells, or an empty bitboard
+     *           if they are not aligned.
+     */
+    Bitboard
+    line(int from, int to) noexcept;
+
+  }
+}
+
+# include "Bitboard.hxx"
+
+#endif    /* BITBOARD_HH */
@@ -0,0 +1,235 @@
+#ifndef    BITBOARD_HXX
+# define   BITBOARD_HXX
+
+# include "Bitboard.hh"
+# include <array>
+
+namespace chess {
+  namespace bitboard {
+    namespace details {
+
+      /// @brief - The directions used by sliding pieces. The
+      /// first four directions increase the index of the cell
+      /// along the ray while the last four decrease it.
+      enum Direction {
+        North,
+        NorthEast,
+        East,
+        NorthWest,
+        South,
+        SouthWest,
+        West,
+        SouthEast,
+        Count
+      };
+
+      /// @brief - Precomputed attack sets, indexed by the linear
+      /// index of the cell of the attacking piece.
+      struct Tables {
+        // The attacks of a knight.
+        std::array<Bitboard, 64u> knight;
+
+        // The attacks of a king, castling excluded.
+        std::array<Bitboard, 64u> king;
+
+        // The captures of a pawn for each color.
+        std::array<std::array<Bitboard, 64u>, 2u> pawn;
+
+        // The rays of cells reachable in each direction from a
+        // cell, assuming the board is empty.
+        std::array<std::array<Bitboard, 64u>, Direction::Count> rays;
+      };
+
+      constexpr
+      Bitboard
+      offset(int x, int y, int dx, int dy) noexcept {
+        int nx = x + dx;
+        int ny = y + dy;
+
+        if (nx < 0 || nx > 7 || ny < 0 || ny > 7) {
+          return 0u;
+        }
+
+        return Bitboard(1u) << (ny * 8 + nx);
+      }
+
+      constexpr
+      Tables
+      generateTables() noexcept {
+        Tables t{};
+
+        constexpr int knight[8][2] = {
+          {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}
+        };
+        constexpr int rays[Direction::Count][2] = {
+          {0, 1}, {1, 1}, {1, 0}, {-1, 1}, {0, -1}, {-1, -1}, {-1, 0}, {1, -1}
+        };
+
+        for (int id = 0 ; id < 64 ; ++id) {
+          int x = id % 8;
+          int y = id / 8;
+
+          for (int k = 0 ; k < 8 ; ++k) {
+            t.knight[id] |= offset(x, y, knight[k][0], knight[k][1]);
+          }
+
+          for (int dy = -1 ; dy <= 1 ; ++dy) {
+            for (int dx = -1 ; dx <= 1 ; ++dx) {
+              if (dx != 0 || dy != 0) {
+                t.king[id] |= offset(x, y, dx, dy);
+              }
+            }
+          }
+
+          t.pawn[0][id] = offset(x, y, -1, 1) | offset(x, y, 1, 1);
+          t.pawn[1][id] = offset(x, y, -1, -1) | offset(x, y, 1, -1);
+
+          for (int d = 0 ; d < Direction::Count ; ++d) {
+            int nx = x + rays[d][0];
+            int ny = y + rays[d][1];
+
+            while (nx >= 0 && nx <= 7 && ny >= 0 && ny <= 7) {
+              t.rays[d][id] |= Bitboard(1u) << (ny * 8 + nx);
+
+              nx += rays[d][0];
+              ny += rays[d][1];
+            }
+          }
+        }
+
+        return t;
+      }
+
+      /// @brief - The tables are computed at compile time so that
+      /// no initialization is needed at runtime.
+      inline constexpr Tables TABLES = generateTables();
+
+      inline
+      Bitboard
+      ray(int d, int id, Bitboard occupied) noexcept {
+        Bitboard r = TABLES.rays[d][id];
+        Bitboard blockers = r & occupied;
+
+        if (blockers == 0u) {
+          return r;
+        }
+
+        // The closest blocker is the lowest cell for rays going
+        // up in the board and the highest one for the others.
+        int b = (d < Direction::South ? first(blockers) : last(blockers));
+        return r ^ TABLES.rays[d][b];
+      }
+
+    }
+
+    constexpr
+    Bitboard
+    cell(int id) noexcept {
+      return Bitboard(1u) << id;
+    }
+
+    inline
+    int
+    count(Bitboard b) noexcept {
+      return __builtin_popcountll(b);
+    }
+
+    inline
+    int
+    first(Bitboard b) noexcept {
+      return __builtin_ctzll(b);
+    }
+
+    inline
+    int
+    last(Bitboard b) noexcept {
+      return 63 - __builtin_clzll(b);
+    }
+
+    inline
+    int
+    pop(Bitboard& b) noexcept {
+      int id = first(b);
+      b &= b - 1u;
+
+      return id;
+    }
+
+    inline
+    Bitboard
+    knightAttacks(int id) noexcept {
+      return details::TABLES.knight[id];
+    }
+
+    inline
+    Bitboard
+    kingAttacks(int id) noexcept {
+      return details::TABLES.king[id];
+    }
+
+    inline
+    Bitboard
+    pawnAttacks(const Color& c, int id) noexcept {
+      return details::TABLES.pawn[c == Color::White ? 0u : 1u][id];
+    }
+
+    inline
+    Bitboard
+    bishopAttacks(int id, Bitboard occupied) noexcept {
+      return
+        details::ray(details::NorthEast, id, occupied) |
+        details::ray(details::NorthWest, id, occupied) |
+        details::ray(details::SouthWest, id, occupied) |
+        details::ray(details::SouthEast, id, occupied);
+    }
+
+    inline
+    Bitboard
+    rookAttacks(int id, Bitboard occupied) noexcept {
+      return
+        details::ray(details::North, id, occupied) |
+        details::ray(details::East, id, occupied) |
+        details::ray(details::South, id, occupied) |
+        details::ray(details::West, id, occupied);
+    }
+
+    inline
+    Bitboard
+    queenAttacks(int id, Bitboard occupied) noexcept {
+      return bishopAttacks(id, occupied) | rookAttacks(id, occupied);
+    }
+
+    inline
+    Bitboard
+    between(int from, int to) noexcept {
+      for (int d = 0 ; d < details::Direction::Count ; ++d) {
+        const Bitboard& r = details::TABLES.rays[d][from];
+
+        if ((r & cell(to)) != 0u) {
+          return r & ~details::TABLES.rays[d][to] & ~cell(to);
+        }
+      }
+
+      return 0u;
+    }
+
+    inline
+    Bitboard
+    line(int from, int to) noexcept {
+      for (int d = 0 ; d < details::Direction::Count ; ++d) {
+        const Bitboard& r = details::TABLES.rays[d][from];
+
+        if ((r & cell(to)) != 0u) {
+          // The opposite direction is four positions away.
+          int o = (d + details::Direction::South) % details::Direction::Count;
+          return r | details::TABLES.rays[o][from] | cell(from);
+        }
+      }
+
+      return 0u;
+    }
+
+  }
+}
+
+#endif    /* BITBOARD_HXX */
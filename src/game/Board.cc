@@ -1,48 +1,83 @@
 
 # include "Board.hh"
+# include <cctype>
+# include <cstring>
+# include <algorithm>
+# include <sstream>
+# include <type_traits>
+# include <core_utils/CoreException.hh>
+# include "MoveGeneration.hh"
 
-namespace chess {
+/// @brief - The dimensions of the board, fixed by the
+/// bitboards used to store the pieces.
+# define BOARD_SIZE 8
 
-  Board::Board(int  width,
-               int  height) noexcept:
-    utils::CoreObject("board"),
+namespace {
 
-    m_width(width),
-    m_height(height),
+  inline
+  unsigned
+  bitboardIndex(const chess::Color& c, const chess::Type& t) noexcept {
+    return (c == chess::Color::White ? 0u : 6u) + static_cast<unsigned>(t);
+  }
 
-    m_board(),
-    m_last({
-      Coordinates(-1, -1),
-      Coordinates(-1, -1),
-      PieceData{ Piece::generate(), false },
-      PieceData{ Piece::generate(), false }
-    })
-  {
-    setService("chess");
+  inline
+  unsigned
+  colorIndex(const chess::Color& c) noexcept {
+    return c == chess::Color::White ? 0u : 1u;
+  }
 
-    initialize();
+  /// @brief - The letters used to represent each type of piece
+  /// in a FEN string, in the order of the `Type` enumeration.
+  const char FEN_PIECES[] = "pnbrqk";
+
+  /**
+   * @brief - Raises an error on behalf of the board. The board
+   *          is not a core object so that it stays trivially
+   *          copyable.
+   * @param message - the description of the error.
+   * @param cause - the cause of the error.
+   */
+  [[noreturn]]
+  void
+  error(const std::string& message, const std::string& cause = "") {
+    throw utils::CoreException(message, "board", "chess", cause);
   }
 
-  Board::Board(const Board& b) noexcept:
-    utils::CoreObject("board"),
+}
+
+namespace chess {
 
-    m_width(b.m_width),
-    m_height(b.m_height),
+  static_assert(std::is_trivially_copyable<Board>::value, "Board should be trivially copyable");
 
-    m_board(b.m_board),
-    m_last(b.m_last)
+  Board::Board() noexcept:
+    m_board(),
+    m_moved(0u),
+    m_pieces(),
+    m_occupancy(),
+    m_last({
+      Coordinates(-1, -1),
+      Coordinates(-1, -1),
+      Piece::generate(),
+      Piece::generate()
+    }),
+    m_side(Color::White),
+    m_key(0u),
+    m_middlegame(),
+    m_endgame(),
+    m_phase(0),
+    m_changes()
   {
-    setService("chess");
+    initialize();
   }
 
   int
   Board::w() const noexcept {
-    return m_width;
+    return BOARD_SIZE;
   }
 
   int
   Board::h() const noexcept {
-    return m_height;
+    return BOARD_SIZE;
   }
 
   bool
@@ -53,57 +88,307 @@ namespace chess {
   void
   Board::initialize() noexcept {
     // Initialize the board and any custom initialization.
-    m_board = std::vector<PieceData>(w() * h(), {Piece::generate(), false});
+    reset();
 
     // Whites.
-    m_board[cells::A1] = {Piece::generate(Type::Rook, Color::White), false};
-    m_board[cells::B1] = {Piece::generate(Type::Knight, Color::White), false};
-    m_board[cells::C1] = {Piece::generate(Type::Bishop, Color::White), false};
-    m_board[cells::D1] = {Piece::generate(Type::Queen, Color::White), false};
-    m_board[cells::E1] = {Piece::generate(Type::King, Color::White), false};
-    m_board[cells::F1] = {Piece::generate(Type::Bishop, Color::White), false};
-    m_board[cells::G1] = {Piece::generate(Type::Knight, Color::White), false};
-    m_board[cells::H1] = {Piece::generate(Type::Rook, Color::White), false};
-
-    m_board[cells::A2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::B2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::C2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::D2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::E2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::F2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::G2] = {Piece::generate(Type::Pawn, Color::White), false};
-    m_board[cells::H2] = {Piece::generate(Type::Pawn, Color::White), false};
+    set(cells::A1, Piece::generate(Type::Rook, Color::White));
+    set(cells::B1, Piece::generate(Type::Knight, Color::White));
+    set(cells::C1, Piece::generate(Type::Bishop, Color::White));
+    set(cells::D1, Piece::generate(Type::Queen, Color::White));
+    set(cells::E1, Piece::generate(Type::King, Color::White));
+    set(cells::F1, Piece::generate(Type::Bishop, Color::White));
+    set(cells::G1, Piece::generate(Type::Knight, Color::White));
+    set(cells::H1, Piece::generate(Type::Rook, Color::White));
+
+    set(cells::A2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::B2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::C2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::D2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::E2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::F2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::G2, Piece::generate(Type::Pawn, Color::White));
+    set(cells::H2, Piece::generate(Type::Pawn, Color::White));
 
     // Blacks.
-    m_board[cells::A7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::B7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::C7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::D7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::E7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::F7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::G7] = {Piece::generate(Type::Pawn, Color::Black), false};
-    m_board[cells::H7] = {Piece::generate(Type::Pawn, Color::Black), false};
-
-    m_board[cells::A8] = {Piece::generate(Type::Rook, Color::Black), false};
-    m_board[cells::B8] = {Piece::generate(Type::Knight, Color::Black), false};
-    m_board[cells::C8] = {Piece::generate(Type::Bishop, Color::Black), false};
-    m_board[cells::D8] = {Piece::generate(Type::Queen, Color::Black), false};
-    m_board[cells::E8] = {Piece::generate(Type::King, Color::Black), false};
-    m_board[cells::F8] = {Piece::generate(Type::Bishop, Color::Black), false};
-    m_board[cells::G8] = {Piece::generate(Type::Knight, Color::Black), false};
-    m_board[cells::H8] = {Piece::generate(Type::Rook, Color::Black), false};
+    set(cells::A7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::B7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::C7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::D7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::E7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::F7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::G7, Piece::generate(Type::Pawn, Color::Black));
+    set(cells::H7, Piece::generate(Type::Pawn, Color::Black));
+
+    set(cells::A8, Piece::generate(Type::Rook, Color::Black));
+    set(cells::B8, Piece::generate(Type::Knight, Color::Black));
+    set(cells::C8, Piece::generate(Type::Bishop, Color::Black));
+    set(cells::D8, Piece::generate(Type::Queen, Color::Black));
+    set(cells::E8, Piece::generate(Type::King, Color::Black));
+    set(cells::F8, Piece::generate(Type::Bishop, Color::Black));
+    set(cells::G8, Piece::generate(Type::Knight, Color::Black));
+    set(cells::H8, Piece::generate(Type::Rook, Color::Black));
+
+    // Account for the castling rights in the key.
+    m_key ^= stateKey();
+  }
+
+  void
+  Board::reset() noexcept {
+    m_board.fill(Piece::generate());
+    m_moved = 0u;
+    m_pieces.fill(0u);
+    m_occupancy.fill(0u);
+
+    m_last.origin = Coordinates(-1, -1);
+    m_last.end = Coordinates(-1, -1);
+    m_last.captured = Piece::generate();
+    m_last.raw = Piece::generate();
+
+    // An empty board with white to move has a null key.
+    m_side = Color::White;
+    m_key = 0u;
+
+    m_middlegame.fill(0);
+    m_endgame.fill(0);
+    m_phase = 0;
+    m_changes.clear();
+  }
+
+  void
+  Board::place(const Coordinates& c, const Piece& p, bool moved) {
+    if (!validCoordinates(c)) {
+      error(
+        "Failed to place " + p.fullName() + " at " + c.toString(),
+        "Invalid coordinates"
+      );
+    }
+
+    unsigned id = linear(c);
+    m_key ^= stateKey();
+
+    set(id, p);
+
+    if (moved) {
+      m_moved |= bitboard::cell(id);
+    }
+    else {
+      m_moved &= ~bitboard::cell(id);
+    }
+
+    m_key ^= stateKey();
+  }
+
+  void
+  Board::setLastMove(const Coordinates& origin, const Coordinates& end) noexcept {
+    m_key ^= stateKey();
+
+    m_last.origin = origin;
+    m_last.end = end;
+    m_last.captured = Piece::generate();
+    m_last.raw = Piece::generate();
+
+    m_key ^= stateKey();
+  }
+
+  void
+  Board::fromFEN(const std::string& fen,
+                 Color* side,
+                 unsigned* halfmove,
+                 unsigned* fullmove)
+  {
+    std::istringstream in(fen);
+    std::string placement, player, castling, ep;
+    in >> placement >> player >> castling >> ep;
+
+    if (placement.empty() || (player != "w" && player != "b")) {
+      error("Failed to load position \"" + fen + "\"", "Invalid format");
+    }
+
+    reset();
+
+    // The placement starts from the last row and lists the
+    // cells from left to right.
+    int x = 0;
+    int y = h() - 1;
+
+    for (unsigned id = 0u ; id < placement.size() ; ++id) {
+      char c = placement[id];
+
+      if (c == '/') {
+        if (x != w()) {
+          error("Failed to load position \"" + fen + "\"", "Invalid row " + std::to_string(y + 1));
+        }
+
+        --y;
+        x = 0;
+        continue;
+      }
+
+      if (std::isdigit(c)) {
+        x += c - '0';
+        continue;
+      }
+
+      const char* t = nullptr;
+      if (std::isalpha(c)) {
+        t = std::strchr(FEN_PIECES, std::tolower(c));
+      }
+      if (t == nullptr || !validCoordinates(Coordinates(x, y))) {
+        error("Failed to load position \"" + fen + "\"", "Invalid piece '" + std::string(1u, c) + "'");
+      }
+
+      Color pc = (std::isupper(c) ? Color::White : Color::Black);
+      place(Coordinates(x, y), Piece::generate(static_cast<Type>(t - FEN_PIECES), pc));
+      ++x;
+    }
+
+    if (y != 0 || x != w()) {
+      error("Failed to load position \"" + fen + "\"", "Invalid number of cells");
+    }
+
+    // Kings and rooks which can still castle did not move.
+    m_key ^= stateKey();
+
+    for (unsigned id = 0u ; id < castling.size() ; ++id) {
+      char c = castling[id];
+      int row = (std::isupper(c) ? 0 : h() - 1);
+
+      switch (std::tolower(c)) {
+        case 'k':
+          m_moved &= ~(bitboard::cell(linear(4, row)) | bitboard::cell(linear(w() - 1, row)));
+          break;
+        case 'q':
+          m_moved &= ~(bitboard::cell(linear(4, row)) | bitboard::cell(linear(0, row)));
+          break;
+        case '-':
+          break;
+        default:
+          error("Failed to load position \"" + fen + "\"", "Invalid castling rights \"" + castling + "\"");
+      }
+    }
+
+    m_key ^= stateKey();
+
+    // The en passant cell is behind the pawn which just
+    // moved two cells.
+    if (!ep.empty() && ep != "-") {
+      Coordinates c(cells::fromString(ep));
+      if (c.y() != 2 && c.y() != h() - 3) {
+        error("Failed to load position \"" + fen + "\"", "Invalid en passant cell \"" + ep + "\"");
+      }
+
+      int dy = (c.y() == 2 ? 1 : -1);
+      setLastMove(Coordinates(c.x(), c.y() - dy), Coordinates(c.x(), c.y() + dy));
+    }
+
+    // The move counters are optional.
+    unsigned half = 0u;
+    unsigned full = 1u;
+
+    if (!(in >> half)) {
+      half = 0u;
+    }
+    if (!(in >> full)) {
+      full = 1u;
+    }
+
+    if (player == "b") {
+      m_side = Color::Black;
+      m_key ^= zobrist::side();
+    }
+
+# ifndef NDEBUG
+    verify("Loading " + fen);
+# endif
+
+    if (side != nullptr) {
+      *side = m_side;
+    }
+    if (halfmove != nullptr) {
+      *halfmove = half;
+    }
+    if (fullmove != nullptr) {
+      *fullmove = full;
+    }
+  }
+
+  std::string
+  Board::toFEN(const Color& side,
+               unsigned halfmove,
+               unsigned fullmove) const noexcept
+  {
+    std::string out;
+
+    for (int y = h() - 1 ; y >= 0 ; --y) {
+      int empty = 0;
+
+      for (int x = 0 ; x < w() ; ++x) {
+        const Piece& p = m_board[linear(x, y)];
+
+        if (p.invalid()) {
+          ++empty;
+          continue;
+        }
+
+        if (empty > 0) {
+          out += std::to_string(empty);
+          empty = 0;
+        }
+
+        char c = FEN_PIECES[static_cast<unsigned>(p.type())];
+        out += (p.color() == Color::White ? static_cast<char>(std::toupper(c)) : c);
+      }
+
+      if (empty > 0) {
+        out += std::to_string(empty);
+      }
+      if (y > 0) {
+        out += "/";
+      }
+    }
+
+    out += (side == Color::White ? " w " : " b ");
+
+    // Castling is possible as long as the king and the rook
+    // did not move.
+    unsigned rights = castlingRights();
+
+    std::string castling;
+    if ((rights & zobrist::WhiteKingSide) != 0u) {
+      castling += "K";
+    }
+    if ((rights & zobrist::WhiteQueenSide) != 0u) {
+      castling += "Q";
+    }
+    if ((rights & zobrist::BlackKingSide) != 0u) {
+      castling += "k";
+    }
+    if ((rights & zobrist::BlackQueenSide) != 0u) {
+      castling += "q";
+    }
+
+    out += (castling.empty() ? "-" : castling);
+    out += " ";
+
+    Bitboard ep = enPassant();
+    out += (ep == 0u ? "-" : cells::toString(static_cast<cells::Value>(bitboard::first(ep))));
+
+    out += " " + std::to_string(halfmove);
+    out += " " + std::to_string(fullmove);
+
+    return out;
   }
 
   const Piece&
   Board::at(int x, int y) const {
-    if (x >= m_width || y >= m_height) {
+    if (x >= w() || y >= h()) {
       error(
         "Failed to fetch board piece",
         "Invalid coordinate " + std::to_string(x) + "x" + std::to_string(y)
       );
     }
 
-    return m_board[linear(x, y)].item;
+    return m_board[linear(x, y)];
   }
 
   const Piece&
@@ -115,34 +400,110 @@ namespace chess {
   Board::pieces(const Color& color) const noexcept {
     Pieces out;
 
-    for (unsigned id = 0u ; id < m_board.size() ; ++id) {
-      if (m_board[id].item.valid() && m_board[id].item.color() == color) {
-        out.push_back(std::make_pair(
-          m_board[id].item,
-          Coordinates(id % w(), id / w())
-        ));
-      }
+    // Traverse the occupied cells for this color: this
+    // is done in increasing order of the cells.
+    Bitboard occupied = occupancy(color);
+    while (occupied != 0u) {
+      int id = bitboard::pop(occupied);
+
+      out.push_back(std::make_pair(
+        m_board[id],
+        Coordinates(id % w(), id / w())
+      ));
     }
 
     return out;
   }
 
-  CoordinatesSet
+  Color
+  Board::side() const noexcept {
+    return m_side;
+  }
+
+  Key
+  Board::key() const noexcept {
+    return m_key;
+  }
+
+  Key
+  Board::computeKey() const noexcept {
+    Key k = stateKey();
+
+    if (m_side == Color::Black) {
+      k ^= zobrist::side();
+    }
+
+    Bitboard occupied = occupancy();
+    while (occupied != 0u) {
+      int id = bitboard::pop(occupied);
+      const Piece& p = m_board[id];
+
+      k ^= zobrist::piece(p.color(), p.type(), id);
+    }
+
+    return k;
+  }
+
+  int
+  Board::evaluate(const Color& c) const noexcept {
+    unsigned own = colorIndex(c);
+    unsigned other = 1u - own;
+
+    return evaluation::taper(
+      m_middlegame[own] - m_middlegame[other],
+      m_endgame[own] - m_endgame[other],
+      m_phase
+    );
+  }
+
+  int
+  Board::computeEvaluation(const Color& c) const noexcept {
+    // The pieces are stored as their code so the board can be
+    // scanned as an array of bytes.
+    static_assert(sizeof(Piece) == 1u, "Piece should be stored in a single byte");
+    evaluation::Totals t = evaluation::scan(reinterpret_cast<const std::uint8_t*>(m_board.data()));
+
+    int sign = (c == Color::White ? 1 : -1);
+    return sign * evaluation::taper(t.middlegame, t.endgame, t.phase);
+  }
+
+  const PieceChanges&
+  Board::changes() const noexcept {
+    return m_changes;
+  }
+
+  Bitboard
+  Board::bitboard(const Color& c, const Type& t) const noexcept {
+    return m_pieces[bitboardIndex(c, t)];
+  }
+
+  Bitboard
+  Board::occupancy(const Color& c) const noexcept {
+    return m_occupancy[colorIndex(c)];
+  }
+
+  Bitboard
+  Board::occupancy() const noexcept {
+    return m_occupancy[0u] | m_occupancy[1u];
+  }
+
+  CoordinatesList
   Board::availablePositions(const Coordinates& coords) const noexcept {
     const Piece& c = at(coords);
     // Case of an empty piece: no available position.
     if (c.invalid()) {
-      return CoordinatesSet();
+      return CoordinatesList();
     }
 
-    CoordinatesSet tmp = c.reachable(coords, *this);
+    // Keep the legal moves starting from the input cell.
+    // Promotions generate several moves with the same end
+    // position so we need to filter duplicates.
+    ai::MoveList moves = ai::generate(c.color(), *this);
 
-    // Filter coordinates that lead to the king being
-    // in check.
-    CoordinatesSet out;
-    for (CoordinatesSet::const_iterator it = tmp.cbegin() ; it != tmp.cend() ; ++it) {
-      if (!leadsToCheck(coords, *it)) {
-        out.insert(*it);
+    CoordinatesList out;
+    for (unsigned id = 0u ; id < moves.size() ; ++id) {
+      if (moves[id].start == coords && !out.contains(moves[id].end)) {
+        out.push_back(moves[id].end);
       }
     }
 
@@ -158,8 +519,7 @@ namespace chess {
       );
     }
 
-    const PieceData& c = m_board[linear(p)];
-    return c.moved;
+    return (m_moved & bitboard::cell(linear(p))) != 0u;
   }
 
   bool
@@ -167,76 +527,71 @@ namespace chess {
     return p == m_last.end;
   }
 
-  bool
-  Board::computeCheck(const Color& c) const noexcept {
-    // Gather the list of pieces remaining for the color
-    // opposite to the input. Also, keep track of
-    // position of the king as it will be useful later.
-    // Note that we don't check whether the king can be
-    // found as it is guaranteed by other means.
-    Pieces attackers = pieces(oppositeColor(c));
-    Coordinates king;
-
-    unsigned id = 0u;
-    bool found = false;
-    while (id < m_board.size() && !found) {
-      const Piece& p = m_board[id].item;
-      if (p.king() && p.color() == c) {
-        king = Coordinates(id % w(), id / w());
-        found = true;
-      }
-
-      ++id;
+  Bitboard
+  Board::enPassant() const noexcept {
+    if (!validCoordinates(m_last.end)) {
+      return 0u;
     }
 
-    // Compute the list of threats generated by each
-    // piece for the other colors.
-    CoordinatesSet threats;
-    for (unsigned id = 0u ; id < attackers.size() ; ++id) {
-      CoordinatesSet t = attackers[id].first.reachable(attackers[id].second, *this);
-      threats.merge(t);
+    const Piece& p = m_board[linear(m_last.end)];
+    if (!p.pawn() || std::abs(m_last.end.y() - m_last.origin.y()) != 2) {
+      return 0u;
     }
 
-    // The king is in check if its position appears in
-    // the final list of threats.
-    return threats.count(king) > 0u;
+    int y = (m_last.origin.y() + m_last.end.y()) / 2;
+    return bitboard::cell(linear(m_last.end.x(), y));
   }
 
   bool
-  Board::computeStalemate(const Color& c) const noexcept {
-    // Gather the pieces of the corresponding color.
-    Pieces av = pieces(c);
-
-    // For each piece, traverse the list of possible
-    // moves and see if it leaves the king out of the
-    // check.
-    bool canLeaveCheck = false;
-    unsigned id = 0u;
-
-    while (id < av.size() && !canLeaveCheck) {
-      CoordinatesSet s = av[id].first.reachable(av[id].second, *this);
-
-      CoordinatesSet::const_iterator it = s.cbegin();
-      while (it != s.cend() && !canLeaveCheck) {
-        if (!leadsToCheck(av[id].second, *it)) {
-          verbose(
-            "Move " + av[id].first.name() +
-            " (" + colorToString(av[id].first.color()) + ", " + colorToString(c) +
-            ") from " + av[id].second.toString() +
-            " to " + it->toString() +
-            " prevents check"
-          );
-
-          canLeaveCheck = true;
-        }
+  Board::isSquareAttacked(const Coordinates& square, const Color& by) const noexcept {
+    int id = linear(square);
+
+    // A piece attacks the cell if the same kind of piece
+    // placed on the cell would attack it. Pawns are the
+    // exception as their attacks depend on their color:
+    // we use the attacks of a pawn of the opposite color.
+    if ((bitboard::pawnAttacks(oppositeColor(by), id) & bitboard(by, Type::Pawn)) != 0u) {
+      return true;
+    }
+    if ((bitboard::knightAttacks(id) & bitboard(by, Type::Knight)) != 0u) {
+      return true;
+    }
+    if ((bitboard::kingAttacks(id) & bitboard(by, Type::King)) != 0u) {
+      return true;
+    }
 
-        ++it;
-      }
+    Bitboard occupied = occupancy();
+    Bitboard queens = bitboard(by, Type::Queen);
+
+    Bitboard diagonals = bitboard(by, Type::Bishop) | queens;
+    if (diagonals != 0u && (bitboard::bishopAttacks(id, occupied) & diagonals) != 0u) {
+      return true;
+    }
+
+    Bitboard lines = bitboard(by, Type::Rook) | queens;
+    return lines != 0u && (bitboard::rookAttacks(id, occupied) & lines) != 0u;
+  }
 
-      ++id;
+  bool
+  Board::computeCheck(const Color& c) const noexcept {
+    // Find the position of the king: it is in check if
+    // any piece of the opposite color attacks it.
+    Bitboard kings = bitboard(c, Type::King);
+    if (kings == 0u) {
+      return false;
     }
 
-    return !canLeaveCheck;
+    int kid = bitboard::first(kings);
+    Coordinates king(kid % w(), kid / w());
+
+    return isSquareAttacked(king, oppositeColor(c));
+  }
+
+  bool
+  Board::computeStalemate(const Color& c) const noexcept {
+    // The color is stalemate if it does not have any
+    // legal move.
+    return ai::generate(c, *this).empty();
   }
 
   bool
@@ -255,32 +610,29 @@ namespace chess {
       );
     }
 
-    // Perform the move while preserving the old position.
-    PieceData st = m_board[linear(start)];
-    PieceData en = m_board[linear(end)];
-
     // In case the cell is empty, that's an issue.
-    if (!st.item.valid()) {
+    const Piece& st = at(start);
+    if (!st.valid()) {
       error(
         "Failed to determine if move leads to check",
         "Position " + start.toString() + " is empty"
       );
     }
 
-    bool moved = st.moved;
-    st.moved = true;
+    // Perform the move and revert it afterwards: the board
+    // is restored before returning so this method is still
+    // logically constant.
+    Board& b = const_cast<Board&>(*this);
+    Color c = st.color();
 
-    m_board[linear(start)].item.reset();
-    m_board[linear(end)] = st;
+    UndoRecord r;
+    b.makeMove(start, end, Type::Queen, r);
 
     // Determine whether the king with the color of the
     // starting position is in check.
-    bool status = computeCheck(st.item.color());
+    bool status = computeCheck(c);
 
-    // Restore the state of the board.
-    st.moved = moved;
-    m_board[linear(start)] = st;
-    m_board[linear(end)] = en;
+    b.unmakeMove(r);
 
     return status;
   }
@@ -292,30 +644,17 @@ namespace chess {
     const Piece& e = at(end);
 
     if (sp.invalid()) {
-      warn("Failed to move from " + start.toString(), "Empty location");
       return false;
     }
     if (e.valid() && sp.color() == e.color()) {
-      warn("Move from " + start.toString() + " would conflict with " + end.toString());
       return false;
     }
 
     // Make sure the move is valid: check the list of
-    // reachable positions and verify that the ending
-    // position belong to them.
-    CoordinatesSet avail = sp.reachable(start, *this);
-    if (avail.count(end) == 0) {
-      warn("Move from " + start.toString() + " to " + end.toString() + " for " + sp.name() + " is invalid");
-      return false;
-    }
-
-    // Discard moves that leaves our king in check.
-    if (leadsToCheck(start, end)) {
-      warn("Move from " + start.toString() + " to " + end.toString() + " for " + sp.name() + " would lead to a check");
-      return false;
-    }
-
-    return true;
+    // legal positions and verify that the ending one
+    // belongs to them.
+    CoordinatesList avail = availablePositions(start);
+    return avail.contains(end);
   }
 
   void
@@ -324,46 +663,92 @@ namespace chess {
               bool autoPromote,
               const Type& promotion)
   {
-    // Fetch starting and ending position.
-    PieceData sp = m_board[linear(start)];
-    PieceData e = m_board[linear(end)];
+    apply(start, end, autoPromote ? promotion : Type::None, nullptr);
 
-    // Swap the piece at the starting position with the
-    // one at the end position. We also need to erase
-    // the data at the starting position.
-    sp.moved = true;
-    m_board[linear(end)] = sp;
-    m_board[linear(start)].item.reset();
+# ifndef NDEBUG
+    verify("Moving from " + start.toString() + " to " + end.toString());
+# endif
+  }
 
-    // Handle case of castling.
-    if (sp.item.king() && std::abs(start.x() - end.x()) > 1) {
-      // We consider that the move is allowed so we just
-      // need to move the position of the rook.
-      Coordinates rs(start.x() < end.x() ? w() - 1 : 0, start.y());
-      Coordinates re(start.x() < end.x() ? end.x() - 1 : end.x() + 1, start.y());
+  void
+  Board::makeMove(const Coordinates& start,
+                  const Coordinates& end,
+                  const Type& promotion,
+                  UndoRecord& record) noexcept
+  {
+    apply(start, end, promotion, &record);
+
+# ifndef NDEBUG
+    verify("Making move from " + start.toString() + " to " + end.toString());
+# endif
+  }
 
-      PieceData r = m_board[linear(rs)];
-      m_board[linear(re)] = r;
-      m_board[linear(rs)].item.reset();
+  void
+  Board::unmakeMove(const UndoRecord& r) noexcept {
+    // Revert the rook's move in case of castling. This
+    // needs to happen first as the rook might have been
+    // moved next to the initial position of the king.
+    if (r.castling) {
+      clear(r.rookEnd);
+      set(r.rookStart, r.rook);
     }
 
-    // Handle case of en passant.
-    if (sp.item.pawn() && start.x() != end.x() && !e.item.valid()) {
-      Coordinates cp(end.x() , start.y());
-      m_board[linear(cp)].item.reset();
+    // Restore the piece that moved and the one that was
+    // captured (if any): note that in case of en passant
+    // the captured piece was not at the end position.
+    clear(r.end);
+    if (r.captured.valid()) {
+      set(r.capturedAt, r.captured);
     }
+    set(r.start, r.piece);
 
-    // Register the last move.
-    m_last.origin = start;
-    m_last.end = end;
+    m_moved = r.moved;
+    m_last = r.last;
 
-    m_last.captured = e;
-    m_last.raw = PieceData{ Piece::generate(), false };
+    // The key is restored as is rather than updated.
+    m_side = oppositeColor(m_side);
+    m_key = r.key;
 
-    // Handle auto-promoting if required.
-    if (autoPromote && sp.item.pawn() && (end.y() == 0 || end.y() == h() - 1)) {
-      promote(end, promotion);
-    }
+# ifndef NDEBUG
+    verify("Unmaking move");
+# endif
+  }
+
+  void
+  Board::makeNullMove(UndoRecord& r) noexcept {
+    // Only the information modified by a null move needs to
+    // be saved.
+    r.key = m_key;
+    r.last = m_last;
+
+    m_changes.clear();
+
+    // The en passant capture is not possible anymore.
+    m_key ^= stateKey();
+
+    m_last.origin = Coordinates(-1, -1);
+    m_last.end = Coordinates(-1, -1);
+    m_last.captured = Piece::generate();
+    m_last.raw = Piece::generate();
+
+    m_side = oppositeColor(m_side);
+    m_key ^= zobrist::side();
+    m_key ^= stateKey();
+
+# ifndef NDEBUG
+    verify("Making null move");
+# endif
+  }
+
+  void
+  Board::unmakeNullMove(const UndoRecord& r) noexcept {
+    m_last = r.last;
+    m_side = oppositeColor(m_side);
+    m_key = r.key;
+
+# ifndef NDEBUG
+    verify("Unmaking null move");
+# endif
   }
 
   void
@@ -375,7 +760,7 @@ namespace chess {
       );
     }
 
-    Piece& pi = m_board[linear(p)].item;
+    Piece pi = m_board[linear(p)];
 
     if (!pi.valid() || !pi.pawn()) {
       error(
@@ -384,19 +769,85 @@ namespace chess {
       );
     }
 
-    verbose("Promoting " + pi.fullName() + " to " + pieceToString(promote));
-
     if (m_last.end == p) {
-      m_last.raw = m_board[linear(p)];
+      m_last.raw = pi;
     }
 
-    pi = Piece::generate(promote, pi.color());
+    set(linear(p), Piece::generate(promote, pi.color()));
+
+# ifndef NDEBUG
+    verify("Promoting " + p.toString());
+# endif
+  }
+
+  unsigned
+  Board::castlingRights() const noexcept {
+    unsigned rights = 0u;
+
+    // A side can castle as long as its king and the rook
+    // did not leave their initial cells.
+    Bitboard wk = bitboard(Color::White, Type::King) & ~m_moved;
+    Bitboard wr = bitboard(Color::White, Type::Rook) & ~m_moved;
+    Bitboard bk = bitboard(Color::Black, Type::King) & ~m_moved;
+    Bitboard br = bitboard(Color::Black, Type::Rook) & ~m_moved;
+
+    if ((wk & bitboard::cell(cells::E1)) != 0u) {
+      if ((wr & bitboard::cell(cells::H1)) != 0u) {
+        rights |= zobrist::WhiteKingSide;
+      }
+      if ((wr & bitboard::cell(cells::A1)) != 0u) {
+        rights |= zobrist::WhiteQueenSide;
+      }
+    }
+    if ((bk & bitboard::cell(cells::E8)) != 0u) {
+      if ((br & bitboard::cell(cells::H8)) != 0u) {
+        rights |= zobrist::BlackKingSide;
+      }
+      if ((br & bitboard::cell(cells::A8)) != 0u) {
+        rights |= zobrist::BlackQueenSide;
+      }
+    }
+
+    return rights;
+  }
+
+  Key
+  Board::stateKey() const noexcept {
+    Key k = zobrist::castling(castlingRights());
+
+    Bitboard ep = enPassant();
+    if (ep != 0u) {
+      k ^= zobrist::enPassant(bitboard::first(ep) % 8);
+    }
+
+    return k;
+  }
+
+  void
+  Board::verify(const std::string& context) const {
+    Key expected = computeKey();
+
+    if (m_key != expected) {
+      error(
+        "Invalid key after " + context,
+        "Expected " + std::to_string(expected) + ", got " + std::to_string(m_key)
+      );
+    }
+
+    int eval = computeEvaluation(Color::White);
+
+    if (evaluate(Color::White) != eval) {
+      error(
+        "Invalid evaluation after " + context,
+        "Expected " + std::to_string(eval) + ", got " + std::to_string(evaluate(Color::White))
+      );
+    }
   }
 
   inline
   unsigned
   Board::linear(int x, int y) const noexcept {
-    return y * m_width + x;
+    return y * w() + x;
   }
 
   inline
@@ -405,4 +856,144 @@ namespace chess {
     return linear(c.x(), c.y());
   }
 
+  void
+  Board::apply(const Coordinates& start,
+               const Coordinates& end,
+               const Type& promotion,
+               UndoRecord* record) noexcept
+  {
+    // Fetch starting and ending position.
+    unsigned s = linear(start);
+    unsigned e = linear(end);
+
+    Piece sp = m_board[s];
+    Piece ep = m_board[e];
+
+    if (record != nullptr) {
+      record->start = s;
+      record->end = e;
+      record->piece = sp;
+      record->captured = ep;
+      record->capturedAt = e;
+      record->castling = false;
+      record->moved = m_moved;
+      record->last = m_last;
+      record->key = m_key;
+    }
+
+    m_changes.clear();
+
+    // The castling rights and the en passant cell are added
+    // back once the move is complete.
+    m_key ^= stateKey();
+
+    // Swap the piece at the starting position with the
+    // one at the end position. We also need to erase
+    // the data at the starting position.
+    set(e, sp);
+    clear(s);
+    m_moved |= bitboard::cell(s) | bitboard::cell(e);
+
+    // Handle case of castling.
+    if (sp.king() && std::abs(start.x() - end.x()) > 1) {
+      // We consider that the move is allowed so we just
+      // need to move the position of the rook.
+      unsigned rs = linear(start.x() < end.x() ? w() - 1 : 0, start.y());
+      unsigned re = linear(start.x() < end.x() ? end.x() - 1 : end.x() + 1, start.y());
+
+      Piece r = m_board[rs];
+
+      if (record != nullptr) {
+        record->castling = true;
+        record->rookStart = rs;
+        record->rookEnd = re;
+        record->rook = r;
+      }
+
+      set(re, r);
+      clear(rs);
+      m_moved |= bitboard::cell(rs) | bitboard::cell(re);
+    }
+
+    // Handle case of en passant.
+    if (sp.pawn() && start.x() != end.x() && !ep.valid()) {
+      unsigned cp = linear(end.x(), start.y());
+
+      if (record != nullptr) {
+        record->captured = m_board[cp];
+        record->capturedAt = cp;
+      }
+
+      clear(cp);
+    }
+
+    // Register the last move.
+    m_last.origin = start;
+    m_last.end = end;
+
+    m_last.captured = ep;
+    m_last.raw = Piece::generate();
+
+    // Handle promotion if required.
+    bool lastRow = (end.y() == 0 || end.y() == h() - 1);
+    if (promotion != Type::None && sp.pawn() && lastRow) {
+      m_last.raw = sp;
+
+      set(e, Piece::generate(promotion, sp.color()));
+    }
+
+    m_side = oppositeColor(m_side);
+    m_key ^= zobrist::side();
+    m_key ^= stateKey();
+  }
+
+  void
+  Board::set(unsigned id, Piece p) noexcept {
+    // Remove whatever is at this cell from the bitboards.
+    clear(id);
+
+    m_board[id] = p;
+
+    if (p.valid()) {
+      Bitboard b = bitboard::cell(id);
+
+      m_pieces[bitboardIndex(p.color(), p.type())] |= b;
+      m_occupancy[colorIndex(p.color())] |= b;
+      m_key ^= zobrist::piece(p.color(), p.type(), id);
+
+      m_middlegame[colorIndex(p.color())] += evaluation::middlegame(p.color(), p.type(), id);
+      m_endgame[colorIndex(p.color())] += evaluation::endgame(p.color(), p.type(), id);
+      m_phase += evaluation::phase(p.type());
+
+      // Only the changes of the last move are kept: other
+      // modifications are ignored once the list is full.
+      if (m_changes.size() < PieceChanges::capacity()) {
+        m_changes.push_back(PieceChange{p, id, true});
+      }
+    }
+  }
+
+  void
+  Board::clear(unsigned id) noexcept {
+    Piece& p = m_board[id];
+
+    if (p.valid()) {
+      Bitboard b = ~bitboard::cell(id);
+
+      m_pieces[bitboardIndex(p.color(), p.type())] &= b;
+      m_occupancy[colorIndex(p.color())] &= b;
+      m_key ^= zobrist::piece(p.color(), p.type(), id);
+
+      m_middlegame[colorIndex(p.color())] -= evaluation::middlegame(p.color(), p.type(), id);
+      m_endgame[colorIndex(p.color())] -= evaluation::endgame(p.color(), p.type(), id);
+      m_phase -= evaluation::phase(p.type());
+
+      if (m_changes.size() < PieceChanges::capacity()) {
+        m_changes.push_back(PieceChange{p, id, false});
+      }
+    }
+
+    p.reset();
+  }
+
 }
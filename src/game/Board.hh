@@ -2,9 +2,14 @@
 # define   BOARD_HH
 
 # include <vector>
+# include <array>
 # include <memory>
-# include <core_utils/CoreObject.hh>
+# include <string>
 # include "Piece.hh"
+# include "Bitboard.hh"
+# include "Zobrist.hh"
+# include "Evaluation.hh"
+# include "FixedList.hh"
 
 namespace chess {
 
@@ -12,15 +17,101 @@ namespace chess {
   /// collection of piece with their coordinates.
   using Pieces = std::vector<std::pair<const Piece, Coordinates>>;
 
-  class Board: public utils::CoreObject {
-    public:
+  /// @brief - A piece added to or removed from a cell of the
+  /// board by a move.
+  struct PieceChange {
+    // The piece added or removed.
+    Piece piece;
 
-      explicit
-      Board(int  width = 8u,
-            int  height = 8u) noexcept;
+    // The linear index of the cell.
+    unsigned cell;
+
+    // Whether the piece was added or removed.
+    bool added;
+  };
+
+  /// @brief - The changes of a single move: a capture with a
+  /// promotion involves at most five of them.
+  using PieceChanges = FixedList<PieceChange, 8u>;
+
+  /// @brief - Convenience structure keeping track of the
+  /// last move's data.
+  struct LastMove {
+    // The coordinates of the starting piece.
+    Coordinates origin;
+
+    // The coordinates of the ending piece.
+    Coordinates end;
+
+    // The captured piece if any.
+    Piece captured;
+
+    // The initial type of the piece sitting at the starting
+    // position. This value is used in case a promotion is
+    // added to the piece that just moved.
+    Piece raw;
+  };
+
+  /// @brief - Convenience structure holding the information
+  /// needed to revert a move. It is filled by the board when
+  /// the move is made and kept by the caller until the move
+  /// is unmade, so that copying a board does not copy the
+  /// moves made on it.
+  struct UndoRecord {
+    // The linear index of the starting cell.
+    unsigned start;
+
+    // The linear index of the ending cell.
+    unsigned end;
+
+    // The piece that moved, before it moved.
+    Piece piece;
+
+    // The captured piece, if any.
+    Piece captured;
+
+    // The cell of the captured piece: this is different
+    // from the end cell in case of en passant.
+    unsigned capturedAt;
+
+    // Whether the move was a castling.
+    bool castling;
+
+    // The initial cell of the rook in case of castling.
+    unsigned rookStart;
+
+    // The final cell of the rook in case of castling.
+    unsigned rookEnd;
+
+    // The rook before castling.
+    Piece rook;
+
+    // The cells of the pieces that moved before this move.
+    Bitboard moved;
+
+    // The key of the position before this move.
+    Key key;
+
+    // The last move before this one.
+    LastMove last;
+  };
+
+  /// @brief - The board stores the position of the pieces as a
+  /// set of bitboards, one per color and type of piece. This
+  /// allows to answer most queries with a couple of bitwise
+  /// operations. A mailbox is kept alongside so that the piece
+  /// at a given cell can be accessed directly: as pieces fit in
+  /// a single byte, it only spans 64 bytes.
+  /// The board only holds the position and is trivially
+  /// copyable: the information needed to unmake moves is kept
+  /// by the caller and errors are reported with exceptions so
+  /// that copying a board is a plain copy of its memory.
+  /// Note that the bitboards require the board to be 8x8.
+  class Board {
+    public:
 
       explicit
-      Board(const Board& b) noexcept;
+      Board() noexcept;
 
       /**
        * @brief - The width of the board.
@@ -50,6 +141,78 @@ namespace chess {
       void
       initialize() noexcept;
 
+      /**
+       * @brief - Removes all the pieces of the board and forget
+       *          about the last move. This is meant to be used
+       *          with `place` to setup a custom position.
+       */
+      void
+      reset() noexcept;
+
+      /**
+       * @brief - Place the input piece at the specified position,
+       *          replacing anything that might be there.
+       *          Raises an error if the coordinates are not valid.
+       * @param c - the coordinates of the cell.
+       * @param p - the piece to place. If it is not valid the
+       *            cell is emptied.
+       * @param moved - whether the piece should be considered to
+       *                have already moved.
+       */
+      void
+      place(const Coordinates& c, const Piece& p, bool moved = true);
+
+      /**
+       * @brief - Defines the last move played on the board. This
+       *          allows to enable en passant in a custom position.
+       *          No piece is moved by this method.
+       * @param origin - the starting position of the last move.
+       * @param end - the ending position of the last move.
+       */
+      void
+      setLastMove(const Coordinates& origin, const Coordinates& end) noexcept;
+
+      /**
+       * @brief - Setup the board with the position described by
+       *          the input FEN string. Pieces are considered to
+       *          have moved unless the castling rights indicate
+       *          otherwise, and the en passant cell is converted
+       *          to the corresponding last move.
+       *          See: https://en.wikipedia.org/wiki/Forsyth%E2%80%93Edwards_Notation
+       *          Raises an error if the string is not valid, in
+       *          which case the board is left in an unspecified
+       *          state.
+       * @param fen - the position to load.
+       * @param side - output argument receiving the side to move.
+       * @param halfmove - output argument receiving the number of
+       *                   half moves since the last capture or pawn
+       *                   move. Set to `0` if not specified.
+       * @param fullmove - output argument receiving the number of
+       *                   the current move. Set to `1` if not
+       *                   specified.
+       */
+      void
+      fromFEN(const std::string& fen,
+              Color* side = nullptr,
+              unsigned* halfmove = nullptr,
+              unsigned* fullmove = nullptr);
+
+      /**
+       * @brief - Generate the FEN string describing the position.
+       *          The castling rights are derived from the pieces
+       *          which did not move yet and the en passant cell
+       *          from the last move.
+       * @param side - the side to move.
+       * @param halfmove - the number of half moves since the last
+       *                   capture or pawn move.
+       * @param fullmove - the number of the current move.
+       * @return - the FEN string for this position.
+       */
+      std::string
+      toFEN(const Color& side,
+            unsigned halfmove = 0u,
+            unsigned fullmove = 1u) const noexcept;
+
       /**
        * @brief - Returns the piece at the specified position or none in
        *          case the cell is empty.
@@ -77,15 +240,102 @@ namespace chess {
       Pieces
       pieces(const Color& color) const noexcept;
 
+      /**
+       * @brief - Returns the color of the side to move. It starts
+       *          with white and changes after each move.
+       * @return - the side to move.
+       */
+      Color
+      side() const noexcept;
+
+      /**
+       * @brief - Returns the Zobrist key of the position, covering
+       *          the pieces, the side to move, the castling rights
+       *          and the file of the en passant cell. The key is
+       *          updated with each modification of the board.
+       * @return - the key of the position.
+       */
+      Key
+      key() const noexcept;
+
+      /**
+       * @brief - Computes the Zobrist key of the position from
+       *          scratch. This should match `key` and is mostly
+       *          useful for debugging.
+       * @return - the key of the position.
+       */
+      Key
+      computeKey() const noexcept;
+
+      /**
+       * @brief - Returns the evaluation of the material and of the
+       *          position of the pieces from the point of view of
+       *          the input color. The middlegame and endgame scores
+       *          are updated with each modification of the board
+       *          and blended based on the phase of the game so the
+       *          evaluation is computed in constant time.
+       * @param c - the color for which the board is evaluated.
+       * @return - the evaluation of the board.
+       */
+      int
+      evaluate(const Color& c) const noexcept;
+
+      /**
+       * @brief - Returns the pieces added and removed by the last
+       *          move made with `makeMove` or `move`. This allows
+       *          to update incrementally any information computed
+       *          from the pieces. A null move has no changes.
+       *          The list is only valid right after the move.
+       * @return - the changes of the last move.
+       */
+      const PieceChanges&
+      changes() const noexcept;
+
+      /**
+       * @brief - Computes the evaluation of the board from scratch.
+       *          This should match `evaluate` and is mostly useful
+       *          for debugging.
+       * @param c - the color for which the board is evaluated.
+       * @return - the evaluation of the board.
+       */
+      int
+      computeEvaluation(const Color& c) const noexcept;
+
+      /**
+       * @brief - Returns the cells occupied by the pieces with the
+       *          input color and type.
+       * @param c - the color of the pieces.
+       * @param t - the type of the pieces. Should not be `None`.
+       * @return - the bitboard of the pieces.
+       */
+      Bitboard
+      bitboard(const Color& c, const Type& t) const noexcept;
+
+      /**
+       * @brief - Returns the cells occupied by any piece of the
+       *          input color.
+       * @param c - the color of the pieces.
+       * @return - the bitboard of the pieces of this color.
+       */
+      Bitboard
+      occupancy(const Color& c) const noexcept;
+
+      /**
+       * @brief - Returns the cells occupied by any piece.
+       * @return - the bitboard of all the pieces.
+       */
+      Bitboard
+      occupancy() const noexcept;
+
       /**
        * @brief - Used to generate the possible positions that can
        *          be reached by the piece at the input coordinates.
-       *          In case the cell is empty, the returned list will
-       *          be empty.
+       *          Only legal moves are returned. In case the cell is
+       *          empty, the returned list will be empty.
        * @param coords - the coordinates of the piece to generate.
        * @return - the list of coordinates reachable by the piece.
        */
-      CoordinatesSet
+      CoordinatesList
       availablePositions(const Coordinates& coords) const noexcept;
 
       /**
@@ -107,6 +357,40 @@ namespace chess {
       bool
       justMoved(const Coordinates& p) const noexcept;
 
+      /**
+       * @brief - Returns the cell where a pawn can be captured en
+       *          passant, that is the cell skipped by the pawn of
+       *          the last move if it was a double push.
+       * @return - a bitboard with the en passant cell set or an
+       *           empty bitboard if no such capture is possible.
+       */
+      Bitboard
+      enPassant() const noexcept;
+
+      /**
+       * @brief - Returns the castling rights, derived from the
+       *          kings and rooks which did not move yet.
+       * @return - a combination of the values of the enumeration
+       *           `zobrist::Castling`.
+       */
+      unsigned
+      castlingRights() const noexcept;
+
+      /**
+       * @brief - Determine whether the input cell is attacked by any
+       *          piece of the input color. The attacks are computed
+       *          backwards from the cell, using the moves of each
+       *          type of piece, and the search stops on the first
+       *          attacker found.
+       *          Note that the cell does not need to be occupied and
+       *          that castling is never considered an attack.
+       * @param square - the cell to check.
+       * @param by - the color of the attacking pieces.
+       * @return - `true` if at least a piece attacks the cell.
+       */
+      bool
+      isSquareAttacked(const Coordinates& square, const Color& by) const noexcept;
+
       /**
        * @brief - Used to compute the check status for the input color
        *          without using the cache.
@@ -172,6 +456,55 @@ namespace chess {
            bool autoPromote = false,
            const Type& promotion = Type::Queen);
 
+      /**
+       * @brief - Similar to `move` but records the information needed
+       *          to revert the move with `unmakeMove`. This is meant
+       *          to be used when exploring moves, as it does not need
+       *          to copy the board.
+       *          Pawns reaching the last row are promoted to the input
+       *          type unless it is `None`.
+       * @param start - the start location to move from.
+       * @param end - the end location to move to.
+       * @param promotion - the type of promotion for pawns.
+       * @param record - output argument receiving the information
+       *                 needed to revert the move.
+       */
+      void
+      makeMove(const Coordinates& start,
+               const Coordinates& end,
+               const Type& promotion,
+               UndoRecord& record) noexcept;
+
+      /**
+       * @brief - Reverts the last move performed with `makeMove`.
+       *          Moves should be unmade in the reverse order.
+       * @param record - the information filled when the move was
+       *                 made.
+       */
+      void
+      unmakeMove(const UndoRecord& record) noexcept;
+
+      /**
+       * @brief - Passes the turn to the other side without moving
+       *          any piece. This is not a legal move and is meant
+       *          to be used by the search to evaluate the threats
+       *          of the opponent. It should be reverted with the
+       *          `unmakeNullMove` method.
+       * @param record - output argument receiving the information
+       *                 needed to revert the null move.
+       */
+      void
+      makeNullMove(UndoRecord& record) noexcept;
+
+      /**
+       * @brief - Reverts the last null move performed with the
+       *          `makeNullMove` method.
+       * @param record - the information filled when the null move
+       *                 was made.
+       */
+      void
+      unmakeNullMove(const UndoRecord& record) noexcept;
+
       /**
        * @brief - Attempts to promote the piece at the position in
        *          input to the desired value.
@@ -192,53 +525,127 @@ namespace chess {
 
     private:
 
-      /// @brief - Convenience structure allowing to keep
-      /// track of the initial square of the piece.
-      struct PieceData {
-        // The piece attached to the data.
-        Piece item;
+      /**
+       * @brief - Place the input piece at the specified cell,
+       *          replacing anything that might be there. This
+       *          method keeps the bitboards and the mailbox in
+       *          sync and should be used for any modification.
+       *          The piece is taken by value as it might refer to
+       *          the content of the cell being replaced.
+       * @param id - the linear index of the cell.
+       * @param p - the piece to place at this cell.
+       */
+      void
+      set(unsigned id, Piece p) noexcept;
 
-        // Whether or not this piece moved.
-        bool moved;
-      };
+      /**
+       * @brief - Removes any piece at the specified cell.
+       * @param id - the linear index of the cell.
+       */
+      void
+      clear(unsigned id) noexcept;
 
-      /// @brief - Convenience structure keeping track of the
-      /// last move's data.
-      struct LastMove {
-        // The coordinates of the starting piece.
-        Coordinates origin;
+      /**
+       * @brief - Returns the part of the key describing the castling
+       *          rights and the en passant cell. These depend on the
+       *          whole position so the key is updated by removing
+       *          this part before a modification and adding it back
+       *          afterwards.
+       * @return - the key for the castling rights and en passant.
+       */
+      Key
+      stateKey() const noexcept;
 
-        // The coordinates of the ending piece.
-        Coordinates end;
+      /**
+       * @brief - Verifies that the key and the scores maintained
+       *          incrementally are the same as the ones computed
+       *          from scratch. Raises an error if this is not the
+       *          case.
+       *          Only used in debug builds.
+       * @param context - a description of the last modification.
+       */
+      void
+      verify(const std::string& context) const;
+
+      /**
+       * @brief - Performs the move from the starting position to
+       *          the end position, handling castling, en passant
+       *          and promotion.
+       * @param start - the start location to move from.
+       * @param end - the end location to move to.
+       * @param promotion - the promotion to apply to pawns reaching
+       *                    the last row, `None` to not promote.
+       * @param record - if not `null`, filled with the information
+       *                 needed to undo the move.
+       */
+      void
+      apply(const Coordinates& start,
+            const Coordinates& end,
+            const Type& promotion,
+            UndoRecord* record) noexcept;
 
-        // The captured piece if any.
-        PieceData captured;
+    private:
 
-        // The initial type of the piece sitting at the starting
-        // position. This value is used in case a promotion is
-        // added to the piece that just moved.
-        PieceData raw;
-      };
+      /**
+       * @brief - The current state of the board, stored as a
+       *          mailbox with one entry per cell.
+       */
+      std::array<Piece, 64u> m_board;
 
       /**
-       * @brief - The width of the board.
+       * @brief - The cells of the pieces which moved since the
+       *          start of the game. A piece leaving a cell also
+       *          marks its destination.
        */
-      int m_width;
+      Bitboard m_moved;
 
       /**
-       * @brief - The height of the board.
+       * @brief - The bitboards of the pieces for each color and
+       *          each type of piece.
        */
-      int m_height;
+      std::array<Bitboard, 12u> m_pieces;
 
       /**
-       * @brief - The current state of the board.
+       * @brief - The bitboards of all pieces for each color.
        */
-      mutable std::vector<PieceData> m_board;
+      std::array<Bitboard, 2u> m_occupancy;
 
       /**
        * @brief - The information about the last move.
        */
       LastMove m_last;
+
+      /**
+       * @brief - The side to move.
+       */
+      Color m_side;
+
+      /**
+       * @brief - The Zobrist key of the position.
+       */
+      Key m_key;
+
+      /**
+       * @brief - The middlegame score of the pieces of each color,
+       *          including their material and position.
+       */
+      std::array<int, 2u> m_middlegame;
+
+      /**
+       * @brief - The endgame score of the pieces of each color.
+       */
+      std::array<int, 2u> m_endgame;
+
+      /**
+       * @brief - The phase of the game computed from the pieces
+       *          remaining on the board.
+       */
+      int m_phase;
+
+      /**
+       * @brief - The pieces added and removed by the last move.
+       */
+      PieceChanges m_changes;
   };
 
   using BoardShPtr = std::shared_ptr<Board>;
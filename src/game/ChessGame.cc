@@ -6,15 +6,15 @@
 
 namespace chess {
 
-  ChessGame::ChessGame(int  width,
-                       int  height) noexcept:
+  ChessGame::ChessGame() noexcept:
     utils::CoreObject("board"),
 
     // White by default.
-    m_board(width, height),
+    m_board(),
 
     m_index(0u),
     m_current(Color::White),
+    m_halfmove(0u),
     m_state({
       false, // Dirty state
       { false, false, false }, // White state
@@ -28,6 +28,21 @@ namespace chess {
     initialize();
   }
 
+  ChessGame::ChessGame(const ChessGame& g) noexcept:
+    utils::CoreObject("board"),
+
+    m_board(g.m_board),
+
+    m_index(g.m_index),
+    m_current(g.m_current),
+    m_halfmove(g.m_halfmove),
+    m_state(g.m_state),
+    m_round(g.m_round),
+    m_rounds(g.m_rounds)
+  {
+    setService("chess");
+  }
+
   const Board&
   ChessGame::operator()() const noexcept {
     return m_board;
@@ -41,6 +56,7 @@ namespace chess {
     // Reset rounds.
     m_index = 0u;
     m_current = Color::White;
+    m_halfmove = 0u;
 
     m_state.dirty = false;
     m_state.white = { false, false, false };
@@ -50,6 +66,30 @@ namespace chess {
     m_rounds.clear();
   }
 
+  void
+  ChessGame::fromFEN(const std::string& fen) {
+    Color side = Color::White;
+    unsigned fullmove = 1u;
+
+    m_board.fromFEN(fen, &side, &m_halfmove, &fullmove);
+
+    // Rounds are numbered from 0.
+    m_index = (fullmove > 0u ? fullmove - 1u : 0u);
+    m_current = side;
+
+    m_state.dirty = true;
+
+    m_round = Round(m_index);
+    m_rounds.clear();
+
+    info("Loaded position \"" + fen + "\"");
+  }
+
+  std::string
+  ChessGame::toFEN() const noexcept {
+    return m_board.toFEN(m_current, m_halfmove, m_index + 1u);
+  }
+
   Color
   ChessGame::getPlayer() const noexcept {
     return m_current;
@@ -115,6 +155,7 @@ namespace chess {
     }
 
     if (!m_board.legal(start, end)) {
+      warn("Move from " + start.toString() + " to " + end.toString() + " for " + sp.name() + " is invalid");
       return false;
     }
 
@@ -126,6 +167,7 @@ namespace chess {
 
   void
   ChessGame::promote(const Coordinates& p, const Type& promote) {
+    verbose("Promoting " + m_board.at(p).fullName() + " to " + pieceToString(promote));
     m_board.promote(p, promote);
 
     // We need to update the round with the promotion.
@@ -203,6 +245,14 @@ namespace chess {
     // Move the piece.
     m_board.move(start, end);
 
+    // Captures and pawn moves reset the half move clock.
+    if (sp.pawn() || e.valid()) {
+      m_halfmove = 0u;
+    }
+    else {
+      ++m_halfmove;
+    }
+
     // Invalidate cached data and update internal states.
     m_state.dirty = true;
     updateState();
@@ -17,8 +17,15 @@ namespace chess {
   class ChessGame: public utils::CoreObject {
     public:
 
-      ChessGame(int  width = 8u,
-                int  height = 8u) noexcept;
+      ChessGame() noexcept;
+
+      /**
+       * @brief - Copy the input game, including its rounds. This
+       *          allows to analyze a snapshot of the game without
+       *          interfering with the original one.
+       * @param g - the game to copy.
+       */
+      ChessGame(const ChessGame& g) noexcept;
 
       /**
        * @brief - Decay the game into its board component.
@@ -33,6 +40,26 @@ namespace chess {
       void
       initialize() noexcept;
 
+      /**
+       * @brief - Initialize the game with the position described
+       *          by the input FEN string. The list of rounds is
+       *          reset and the round index is set from the move
+       *          number of the FEN.
+       *          Raises an error if the string is not valid.
+       * @param fen - the position to load.
+       */
+      void
+      fromFEN(const std::string& fen);
+
+      /**
+       * @brief - Generate the FEN string describing the current
+       *          position of the game, including the side to move
+       *          and the move counters.
+       * @return - the FEN string for this game.
+       */
+      std::string
+      toFEN() const noexcept;
+
       /**
        * @brief - Returns the current color playing the next
        *          round.
@@ -172,6 +199,12 @@ namespace chess {
        */
       Color m_current;
 
+      /**
+       * @brief - The number of half moves since the last capture
+       *          or pawn move.
+       */
+      unsigned m_halfmove;
+
       /**
        * @brief - The current state of the board.
        */
@@ -0,0 +1,109 @@
+#ifndef    EVALUATION_HH
+# define   EVALUATION_HH
+
+# include <cstdint>
+# include "Piece.hh"
+
+/// @brief - The game phase of the starting position: the
+/// phase decreases as pieces are captured, down to zero
+/// when only pawns and kings remain.
+# define EVALUATION_PHASE_MAX 24
+
+namespace chess {
+  namespace evaluation {
+
+    /// @brief - The scores of all the pieces of a board from
+    /// the point of view of white, before blending them.
+    struct Totals {
+      // The middlegame score.
+      int middlegame;
+
+      // The endgame score.
+      int endgame;
+
+      // The phase of the game.
+      int phase;
+    };
+
+    /**
+     * @brief - Returns the score of a piece on a cell in the
+     *          middlegame: its material value and the bonus of
+     *          its piece-square table. The score is given from
+     *          the point of view of the color of the piece.
+     * @param c - the color of the piece.
+     * @param t - the type of the piece. Should not be `None`.
+     * @param id - the linear index of the cell.
+     * @return - the score of the piece.
+     */
+    int
+    middlegame(const Color& c, const Type& t, int id) noexcept;
+
+    /**
+     * @brief - Returns the score of a piece on a cell in the
+     *          endgame, similar to `middlegame`.
+     * @param c - the color of the piece.
+     * @param t - the type of the piece. Should not be `None`.
+     * @param id - the linear index of the cell.
+     * @return - the score of the piece.
+     */
+    int
+    endgame(const Color& c, const Type& t, int id) noexcept;
+
+    /**
+     * @brief - Returns the contribution of a piece to the game
+     *          phase. Pawns and kings don't contribute.
+     * @param t - the type of the piece.
+     * @return - the contribution to the phase.
+     */
+    int
+    phase(const Type& t) noexcept;
+
+    /**
+     * @brief - Returns the material value of a piece, without
+     *          its position. The king and `None` are worth `0`.
+     * @param t - the type of the piece.
+     * @return - the value of the piece.
+     */
+    int
+    value(const Type& t) noexcept;
+
+    /**
+     * @brief - Blends a middlegame and an endgame score based
+     *          on the phase of the game.
+     * @param middlegame - the middlegame score.
+     * @param endgame - the endgame score.
+     * @param phase - the phase, larger values being closer to
+     *                the middlegame. It is clamped to the phase
+     *                of the starting position.
+     * @return - the blended score.
+     */
+    int
+    taper(int middlegame, int endgame, int phase) noexcept;
+
+    /**
+     * @brief - Computes the scores of all the pieces of a board
+     *          given as the code of the piece on each of its 64
+     *          cells. This uses AVX2 instructions when they are
+     *          available and falls back to `scanScalar` otherwise.
+     * @param codes - the codes of the pieces, indexed by cell.
+     * @return - the scores of the board.
+     */
+    Totals
+    scan(const std::uint8_t* codes) noexcept;
+
+    /**
+     * @brief - Computes the scores of all the pieces of a board
+     *          one cell at a time. Produces the same result as
+     *          `scan`.
+     * @param codes - the codes of the pieces, indexed by cell.
+     * @return - the scores of the board.
+     */
+    Totals
+    scanScalar(const std::uint8_t* codes) noexcept;
+
+  }
+}
+
+# include "Evaluation.hxx"
+
+#endif    /* EVALUATION_HH */
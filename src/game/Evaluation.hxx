@@ -0,0 +1,309 @@
+#ifndef    EVALUATION_HXX
+# define   EVALUATION_HXX
+
+# include "Evaluation.hh"
+# include <array>
+
+# if defined(__AVX2__)
+#  include <immintrin.h>
+# endif
+
+namespace chess {
+  namespace evaluation {
+    namespace details {
+
+      /// @brief - A piece-square table, written from the point
+      /// of view of white with the eighth rank first so that it
+      /// reads like a board.
+      using Table = std::array<int, 64u>;
+
+      /// @brief - The scores of each piece on each cell, indexed
+      /// by the color, the type of the piece and the cell.
+      using Scores = std::array<std::array<std::array<int, 64u>, 6u>, 2u>;
+
+      /// @brief - The precomputed scores for both phases.
+      struct Tables {
+        // The scores in the middlegame.
+        Scores middlegame;
+
+        // The scores in the endgame.
+        Scores endgame;
+      };
+
+      /// @brief - The material value of each piece in the order
+      /// of the `Type` enumeration.
+      constexpr std::array<int, 6u> MIDDLEGAME_VALUES = {100, 320, 330, 500, 900, 0};
+      constexpr std::array<int, 6u> ENDGAME_VALUES = {120, 300, 330, 520, 900, 0};
+
+      /// @brief - The contribution of each piece to the phase.
+      constexpr std::array<int, 6u> PHASES = {0, 1, 1, 2, 4, 0};
+
+      // The middlegame tables are the ones of the simplified
+      // evaluation function. See:
+      // https://www.chessprogramming.org/Simplified_Evaluation_Function
+      constexpr Table PAWN_MIDDLEGAME = {
+         0,  0,  0,  0,  0,  0,  0,  0,
+        50, 50, 50, 50, 50, 50, 50, 50,
+        10, 10, 20, 30, 30, 20, 10, 10,
+         5,  5, 10, 25, 25, 10,  5,  5,
+         0,  0,  0, 20, 20,  0,  0,  0,
+         5, -5,-10,  0,  0,-10, -5,  5,
+         5, 10, 10,-20,-20, 10, 10,  5,
+         0,  0,  0,  0,  0,  0,  0,  0
+      };
+
+      // In the endgame pawns are worth more as they get close
+      // to promotion, wherever they are on the rank.
+      constexpr Table PAWN_ENDGAME = {
+         0,  0,  0,  0,  0,  0,  0,  0,
+        80, 80, 80, 80, 80, 80, 80, 80,
+        50, 50, 50, 50, 50, 50, 50, 50,
+        30, 30, 30, 30, 30, 30, 30, 30,
+        15, 15, 15, 15, 15, 15, 15, 15,
+         5,  5,  5,  5,  5,  5,  5,  5,
+         0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0
+      };
+
+      constexpr Table KNIGHT = {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50
+      };
+
+      constexpr Table BISHOP = {
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20
+      };
+
+      constexpr Table ROOK = {
+         0,  0,  0,  0,  0,  0,  0,  0,
+         5, 10, 10, 10, 10, 10, 10,  5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+         0,  0,  0,  5,  5,  0,  0,  0
+      };
+
+      constexpr Table QUEEN = {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20
+      };
+
+      constexpr Table KING_MIDDLEGAME = {
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20
+      };
+
+      constexpr Table KING_ENDGAME = {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50
+      };
+
+      constexpr
+      Tables
+      generateTables() noexcept {
+        Tables t{};
+
+        const Table* middlegame[] = {&PAWN_MIDDLEGAME, &KNIGHT, &BISHOP, &ROOK, &QUEEN, &KING_MIDDLEGAME};
+        const Table* endgame[] = {&PAWN_ENDGAME, &KNIGHT, &BISHOP, &ROOK, &QUEEN, &KING_ENDGAME};
+
+        for (unsigned p = 0u ; p < 6u ; ++p) {
+          for (unsigned id = 0u ; id < 64u ; ++id) {
+            // The first row of the tables is the eighth rank:
+            // the cell is flipped vertically for white, and
+            // black uses the table as is.
+            unsigned white = id ^ 56u;
+
+            t.middlegame[0u][p][id] = MIDDLEGAME_VALUES[p] + (*middlegame[p])[white];
+            t.middlegame[1u][p][id] = MIDDLEGAME_VALUES[p] + (*middlegame[p])[id];
+
+            t.endgame[0u][p][id] = ENDGAME_VALUES[p] + (*endgame[p])[white];
+            t.endgame[1u][p][id] = ENDGAME_VALUES[p] + (*endgame[p])[id];
+          }
+        }
+
+        return t;
+      }
+
+      /// @brief - The scores are computed at compile time.
+      inline constexpr Tables TABLES = generateTables();
+
+      /// @brief - The number of piece codes: the color is held
+      /// by the fourth bit of the code and `0` is an empty cell.
+      constexpr unsigned CODES = 16u;
+
+      /// @brief - The middlegame and endgame scores of each code
+      /// on each cell packed in a single integer, from the point
+      /// of view of white. The endgame score is stored in the
+      /// upper half so that the packed values can be summed: the
+      /// middlegame score of a board always fits in 16 bits.
+      using Packed = std::array<std::int32_t, CODES * 64u>;
+
+      constexpr
+      Packed
+      generatePacked() noexcept {
+        Packed packed{};
+
+        for (unsigned code = 0u ; code < CODES ; ++code) {
+          unsigned t = (code & 7u);
+          if (t == 0u || t > 6u) {
+            continue;
+          }
+
+          unsigned c = (code >> 3u);
+          int sign = (c == 0u ? 1 : -1);
+
+          for (unsigned id = 0u ; id < 64u ; ++id) {
+            int middlegame = sign * TABLES.middlegame[c][t - 1u][id];
+            int endgame = sign * TABLES.endgame[c][t - 1u][id];
+
+            packed[code * 64u + id] = middlegame + endgame * 65536;
+          }
+        }
+
+        return packed;
+      }
+
+      /// @brief - The packed scores are computed at compile time.
+      inline constexpr Packed PACKED = generatePacked();
+
+      /// @brief - The contribution to the phase of each code.
+      alignas(16) inline constexpr std::array<std::uint8_t, CODES> CODE_PHASES = {
+        0, 0, 1, 1, 2, 4, 0, 0,
+        0, 0, 1, 1, 2, 4, 0, 0
+      };
+
+      inline
+      Totals
+      unpack(std::int32_t packed, int phase) noexcept {
+        int middlegame = static_cast<std::int16_t>(static_cast<std::uint16_t>(packed & 0xFFFF));
+        int endgame = (packed - middlegame) / 65536;
+
+        return Totals{middlegame, endgame, phase};
+      }
+
+    }
+
+    inline
+    int
+    middlegame(const Color& c, const Type& t, int id) noexcept {
+      return details::TABLES.middlegame[c == Color::White ? 0u : 1u][static_cast<unsigned>(t)][id];
+    }
+
+    inline
+    int
+    endgame(const Color& c, const Type& t, int id) noexcept {
+      return details::TABLES.endgame[c == Color::White ? 0u : 1u][static_cast<unsigned>(t)][id];
+    }
+
+    inline
+    int
+    phase(const Type& t) noexcept {
+      return (t == Type::None ? 0 : details::PHASES[static_cast<unsigned>(t)]);
+    }
+
+    inline
+    int
+    value(const Type& t) noexcept {
+      return (t == Type::None ? 0 : details::MIDDLEGAME_VALUES[static_cast<unsigned>(t)]);
+    }
+
+    inline
+    int
+    taper(int middlegame, int endgame, int phase) noexcept {
+      // Promotions can raise the phase above its initial value.
+      int p = (phase > EVALUATION_PHASE_MAX ? EVALUATION_PHASE_MAX : phase);
+      return (middlegame * p + endgame * (EVALUATION_PHASE_MAX - p)) / EVALUATION_PHASE_MAX;
+    }
+
+    inline
+    Totals
+    scan(const std::uint8_t* codes) noexcept {
+# if defined(__AVX2__)
+      // The scores are gathered from the packed table for eight
+      // cells at a time, at the offset `code * 64 + cell`.
+      const __m256i cells = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+      __m256i sums = _mm256_setzero_si256();
+
+      for (unsigned id = 0u ; id < 64u ; id += 8u) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + id));
+        __m256i offsets = _mm256_slli_epi32(_mm256_cvtepu8_epi32(bytes), 6);
+        offsets = _mm256_add_epi32(offsets, _mm256_add_epi32(cells, _mm256_set1_epi32(id)));
+
+        sums = _mm256_add_epi32(sums, _mm256_i32gather_epi32(details::PACKED.data(), offsets, 4));
+      }
+
+      __m128i packed = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+      packed = _mm_add_epi32(packed, _mm_shuffle_epi32(packed, 0x4E));
+      packed = _mm_add_epi32(packed, _mm_shuffle_epi32(packed, 0xB1));
+
+      // The phase of each cell is looked up with a shuffle of
+      // the codes, and the bytes are summed in groups of eight.
+      const __m256i lookup = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(details::CODE_PHASES.data()))
+      );
+
+      __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes));
+      __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + 32u));
+      __m256i phases = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+      phases = _mm256_sad_epu8(phases, _mm256_setzero_si256());
+
+      __m128i phase = _mm_add_epi64(_mm256_castsi256_si128(phases), _mm256_extracti128_si256(phases, 1));
+      phase = _mm_add_epi64(phase, _mm_unpackhi_epi64(phase, phase));
+
+      return details::unpack(_mm_cvtsi128_si32(packed), _mm_cvtsi128_si32(phase));
+# else
+      return scanScalar(codes);
+# endif
+    }
+
+    inline
+    Totals
+    scanScalar(const std::uint8_t* codes) noexcept {
+      std::int32_t packed = 0;
+      int phase = 0;
+
+      for (unsigned id = 0u ; id < 64u ; ++id) {
+        packed += details::PACKED[codes[id] * 64u + id];
+        phase += details::CODE_PHASES[codes[id]];
+      }
+
+      return details::unpack(packed, phase);
+    }
+
+  }
+}
+
+#endif    /* EVALUATION_HXX */
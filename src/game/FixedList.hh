@@ -0,0 +1,108 @@
+#ifndef    FIXED_LIST_HH
+# define   FIXED_LIST_HH
+
+# include <array>
+# include <cstddef>
+
+namespace chess {
+
+  /// @brief - A list of elements with a capacity fixed at
+  /// compile time. The storage is held inline so that such
+  /// a list can live on the stack without any allocation.
+  /// Elements are kept in insertion order, which makes the
+  /// iteration deterministic.
+  /// No check is performed when adding elements: the users
+  /// are expected to pick a capacity large enough for the
+  /// data they store.
+  template <typename T, std::size_t N>
+  class FixedList {
+    public:
+
+      /**
+       * @brief - Create an empty list.
+       */
+      FixedList() noexcept;
+
+      /**
+       * @brief - The number of elements in the list.
+       * @return - the size of the list.
+       */
+      std::size_t
+      size() const noexcept;
+
+      /**
+       * @brief - The maximum number of elements that can be
+       *          stored in the list.
+       * @return - the capacity of the list.
+       */
+      static
+      constexpr
+      std::size_t
+      capacity() noexcept;
+
+      /**
+       * @brief - Whether or not the list is empty.
+       * @return - `true` if the list has no elements.
+       */
+      bool
+      empty() const noexcept;
+
+      /**
+       * @brief - Removes all the elements of the list.
+       */
+      void
+      clear() noexcept;
+
+      /**
+       * @brief - Appends the input element at the end of
+       *          the list.
+       * @param t - the element to add.
+       */
+      void
+      push_back(const T& t) noexcept;
+
+      /**
+       * @brief - Whether or not the input element is part
+       *          of the list.
+       * @param t - the element to search for.
+       * @return - `true` if the element is in the list.
+       */
+      bool
+      contains(const T& t) const noexcept;
+
+      T&
+      operator[](std::size_t id) noexcept;
+
+      const T&
+      operator[](std::size_t id) const noexcept;
+
+      T*
+      begin() noexcept;
+
+      T*
+      end() noexcept;
+
+      const T*
+      begin() const noexcept;
+
+      const T*
+      end() const noexcept;
+
+    private:
+
+      /**
+       * @brief - The storage for the elements.
+       */
+      std::array<T, N> m_data;
+
+      /**
+       * @brief - The number of elements in the list.
+       */
+      std::size_t m_size;
+  };
+
+}
+
+# include "FixedList.hxx"
+
+#endif    /* FIXED_LIST_HH */
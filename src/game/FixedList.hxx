@@ -0,0 +1,108 @@
+#ifndef    FIXED_LIST_HXX
+# define   FIXED_LIST_HXX
+
+# include "FixedList.hh"
+
+namespace chess {
+
+  template <typename T, std::size_t N>
+  inline
+  FixedList<T, N>::FixedList() noexcept:
+    m_data(),
+    m_size(0u)
+  {}
+
+  template <typename T, std::size_t N>
+  inline
+  std::size_t
+  FixedList<T, N>::size() const noexcept {
+    return m_size;
+  }
+
+  template <typename T, std::size_t N>
+  constexpr
+  std::size_t
+  FixedList<T, N>::capacity() noexcept {
+    return N;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  bool
+  FixedList<T, N>::empty() const noexcept {
+    return m_size == 0u;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  void
+  FixedList<T, N>::clear() noexcept {
+    m_size = 0u;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  void
+  FixedList<T, N>::push_back(const T& t) noexcept {
+    m_data[m_size] = t;
+    ++m_size;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  bool
+  FixedList<T, N>::contains(const T& t) const noexcept {
+    for (std::size_t id = 0u ; id < m_size ; ++id) {
+      if (m_data[id] == t) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  T&
+  FixedList<T, N>::operator[](std::size_t id) noexcept {
+    return m_data[id];
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  const T&
+  FixedList<T, N>::operator[](std::size_t id) const noexcept {
+    return m_data[id];
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  T*
+  FixedList<T, N>::begin() noexcept {
+    return m_data.data();
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  T*
+  FixedList<T, N>::end() noexcept {
+    return m_data.data() + m_size;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  const T*
+  FixedList<T, N>::begin() const noexcept {
+    return m_data.data();
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  const T*
+  FixedList<T, N>::end() const noexcept {
+    return m_data.data() + m_size;
+  }
+
+}
+
+#endif    /* FIXED_LIST_HXX */
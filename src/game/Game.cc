@@ -1,8 +1,10 @@
 
 # include "Game.hh"
 # include <cxxabi.h>
+# include <fstream>
 # include "Menu.hh"
 # include "MinimaxAI.hh"
+# include "NetworkEvaluator.hh"
 
 /// @brief - The duration of the alert prompting that
 /// the current player is in check, in stalemate or
@@ -13,9 +15,50 @@
 /// the history.
 # define MOVES_COUNT 3u
 
-/// @brief - The depth of the tree considered for the
-/// AI.
-# define AI_TREE_DEPTH 3u
+/// @brief - The maximum depth of the tree considered for
+/// the AI.
+# define AI_MAX_DEPTH 32u
+
+/// @brief - The time allowed to the AI to pick a move in
+/// milliseconds.
+# define AI_TIME_BUDGET_MS 1000u
+
+/// @brief - The maximum number of nodes visited by the AI
+/// to pick a move, `0` means no limit.
+# define AI_NODES_BUDGET 0u
+
+/// @brief - The memory budget in megabytes of the table
+/// caching the positions searched by the AI.
+# define AI_HASH_SIZE_MB 16u
+
+/// @brief - The number of threads searching in parallel
+/// when the AI picks a move.
+# define AI_THREADS 2u
+
+/// @brief - The file holding the weights of the neural
+/// network evaluating positions. The AI uses the material
+/// and piece-square evaluation if it does not exist.
+# define AI_NETWORK_FILE "data/network.nnue"
+
+/// @brief - The folder holding the endgame tables generated
+/// by `chess_tbgen`. Missing tables are not probed.
+# define AI_TABLEBASE_DIRECTORY "data/tablebases"
+
+/// @brief - The opening book in the Polyglot format used by
+/// the AI. The AI searches all positions if it does not exist.
+# define AI_BOOK_FILE "data/book.bin"
+
+/// @brief - The number of moves of the AI for which the
+/// opening book is probed.
+# define AI_BOOK_DEPTH 12u
+
+/// @brief - How much the AI varies the moves it picks from
+/// the opening book, between 0 and 1.
+# define AI_BOOK_RANDOMNESS 0.5f
+
+/// @brief - The file receiving the events of the last search
+/// of the AI when tracing is enabled.
+# define AI_TRACE_FILE "data/trace.bin"
 
 namespace {
 
@@ -86,13 +129,34 @@ namespace pge {
     m_board(board),
     m_start(nullptr),
     m_promote(nullptr),
-    m_ai(std::make_shared<chess::MinimaxAI>(chess::Color::Black, AI_TREE_DEPTH)),
+    m_evaluator(loadEvaluator()),
+    m_tablebase(std::make_shared<chess::ai::Tablebase>(AI_TABLEBASE_DIRECTORY)),
+    m_book(std::make_shared<chess::ai::Book>(AI_BOOK_FILE)),
+    m_ai(
+      std::make_shared<chess::MinimaxAI>(
+        chess::Color::Black,
+        chess::ai::SearchLimits{AI_MAX_DEPTH, AI_TIME_BUDGET_MS, AI_NODES_BUDGET},
+        AI_HASH_SIZE_MB,
+        AI_THREADS,
+        chess::ai::Pruning{true, true, true, true},
+        m_evaluator,
+        m_tablebase,
+        m_book,
+        chess::ai::BookSettings{AI_BOOK_DEPTH, AI_BOOK_RANDOMNESS}
+      )
+    ),
+    m_thinking(),
+    m_pondering(false),
+    m_ponderKey(0u),
+    m_tracing(false),
     m_menus()
   {
     setService("game");
   }
 
-  Game::~Game() {}
+  Game::~Game() {
+    cancelAI();
+  }
 
   std::vector<MenuShPtr>
   Game::generateMenus(float width,
@@ -288,6 +352,15 @@ namespace pge {
       return;
     }
 
+    // The AI searches on a worker thread during its turn: the
+    // pieces of its color should not be moved by the user in
+    // the meantime. Pondering happens on the turn of the user
+    // so actions are still allowed then.
+    if (m_board->getPlayer() == m_ai->side()) {
+      debug("Ignoring action while AI is thinking");
+      return;
+    }
+
     const chess::Board& b = (*m_board)();
 
     chess::CoordinatesShPtr coords = convertCoords(x, y, 1.0f * b.w(), 1.0f * b.h(), getPlayer());
@@ -355,9 +428,9 @@ namespace pge {
     }
 
     // Make the AI play as the move was valid if we reach this
-    // point: this will make sure that the user can play again
-    // immediately.
-    m_ai->play(*m_board);
+    // point: the move will be applied once the AI is done
+    // thinking.
+    think();
 
     // Reset starting location after the move.
     m_start.reset();
@@ -370,6 +443,7 @@ namespace pge {
       return true;
     }
 
+    updateAI();
     updateUI();
 
     // Disable UI in case the game is done.
@@ -396,6 +470,19 @@ namespace pge {
     enable(!m_state.paused);
   }
 
+  void
+  Game::toggleTracing() noexcept {
+    m_tracing = !m_tracing;
+    m_ai->trace(m_tracing ? AI_TRACE_FILE : "");
+
+    if (m_tracing) {
+      info("Recording search of the AI to \"" + std::string(AI_TRACE_FILE) + "\"");
+    }
+    else {
+      info("Stopped recording search of the AI");
+    }
+  }
+
   void
   Game::resume() {
     // Do nothing in case the game is already running.
@@ -406,16 +493,30 @@ namespace pge {
     info("Game is now resumed");
     m_state.paused = false;
 
-    // Also, make the AI play: this will make sure that
-    // in case it's needed the player will be able to
-    // play right away.
-    m_ai->play(*m_board);
+    // Also, make the AI play: in case it's needed the
+    // player will be able to play once it's done.
+    think();
   }
 
   void
   Game::setPlayer(const chess::Color& color) noexcept {
+    // Discard the move of the previous AI if it was still
+    // thinking as the board will be reset.
+    cancelAI();
+
     // Create the AI with the oppostie color as the player.
-    m_ai = std::make_shared<chess::MinimaxAI>(oppositeColor(color), AI_TREE_DEPTH);
+    m_ai = std::make_shared<chess::MinimaxAI>(
+      oppositeColor(color),
+      chess::ai::SearchLimits{AI_MAX_DEPTH, AI_TIME_BUDGET_MS, AI_NODES_BUDGET},
+      AI_HASH_SIZE_MB,
+      AI_THREADS,
+      chess::ai::Pruning{true, true, true, true},
+      m_evaluator,
+      m_tablebase,
+      m_book,
+      chess::ai::BookSettings{AI_BOOK_DEPTH, AI_BOOK_RANDOMNESS}
+    );
+    m_ai->trace(m_tracing ? AI_TRACE_FILE : "");
     info("Player will be " + colorToString(color));
 
     // Reset the board.
@@ -452,8 +553,8 @@ namespace pge {
     }
 
     // Resume the course of the move: the AI should play
-    // play and we can reset the starting location.
-    m_ai->play(*m_board);
+    // and we can reset the starting location.
+    think();
     m_start.reset();
   }
 
@@ -465,6 +566,139 @@ namespace pge {
     m_state.resigned = true;
   }
 
+  void
+  Game::think() noexcept {
+    // In case the AI is searching on the time of the player
+    // check whether the player made the expected move.
+    if (m_pondering) {
+      if (m_board->getPlayer() != m_ai->side()) {
+        return;
+      }
+
+      if ((*m_board)().key() == m_ponderKey) {
+        // The search goes on with its regular budget: its
+        // move will be applied as soon as it's done.
+        debug("Player made the expected move");
+        m_pondering = false;
+        m_ai->ponderHit();
+
+        return;
+      }
+
+      cancelAI();
+    }
+
+    if (m_thinking.valid()) {
+      return;
+    }
+
+    // The AI only plays on its turn: this prevents from
+    // starting a search which would not produce a move.
+    if (m_board->getPlayer() != m_ai->side()) {
+      return;
+    }
+
+    search(*m_board);
+  }
+
+  void
+  Game::ponder() noexcept {
+    chess::ai::Move reply;
+    if (!m_ai->expectedReply(reply)) {
+      return;
+    }
+
+    // Search the position reached after the expected move
+    // of the player while they're thinking.
+    chess::ChessGame snapshot(*m_board);
+    if (!m_ai->apply(snapshot, reply)) {
+      return;
+    }
+
+    debug("Pondering on " + reply.start.toString() + " to " + reply.end.toString());
+
+    m_ponderKey = snapshot().key();
+    m_pondering = true;
+
+    m_ai->ponder();
+    search(snapshot);
+  }
+
+  void
+  Game::search(const chess::ChessGame& game) noexcept {
+    // The worker owns a copy of the game and of the pointer
+    // to the AI so that the search is not affected if they
+    // are modified in the meantime.
+    chess::ChessGame snapshot(game);
+    chess::AIShPtr ai = m_ai;
+
+    m_thinking = std::async(
+      std::launch::async,
+      [snapshot, ai]() {
+        chess::ai::Move best;
+        bool valid = ai->pick(snapshot, best);
+
+        return Thinking{valid, best};
+      }
+    );
+  }
+
+  void
+  Game::updateAI() noexcept {
+    // The move found while pondering can only be applied
+    // once the player made the expected move.
+    if (!m_thinking.valid() || m_pondering) {
+      return;
+    }
+
+    if (m_thinking.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+
+    Thinking out = m_thinking.get();
+    if (out.valid && m_ai->apply(*m_board, out.move)) {
+      ponder();
+    }
+  }
+
+  void
+  Game::cancelAI() noexcept {
+    m_pondering = false;
+
+    if (!m_thinking.valid()) {
+      return;
+    }
+
+    // The entries stored in the table by the search are
+    // kept as they can be useful for the next one.
+    m_ai->stop();
+    m_thinking.wait();
+    m_thinking = std::future<Thinking>();
+
+    debug("Discarded move of the AI");
+  }
+
+  chess::ai::EvaluatorShPtr
+  Game::loadEvaluator() noexcept {
+    std::ifstream in(AI_NETWORK_FILE);
+    if (!in.good()) {
+      return nullptr;
+    }
+
+    try {
+      chess::ai::NetworkShPtr network = std::make_shared<chess::ai::Network>(AI_NETWORK_FILE);
+      return std::make_shared<chess::ai::NetworkEvaluator>(network);
+    }
+    catch (const utils::CoreException& e) {
+      warn(
+        "Failed to load network, using piece-square evaluation",
+        e.what()
+      );
+    }
+
+    return nullptr;
+  }
+
   void
   Game::enable(bool enable) {
     m_state.disabled = !enable;
@@ -601,6 +835,9 @@ namespace pge {
     else if (c) {
       st = "Check";
     }
+    else if (m_thinking.valid() && !m_pondering) {
+      st = "Thinking...";
+    }
     m_menus.status->setText(st);
   }
 
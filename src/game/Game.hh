@@ -3,10 +3,14 @@
 
 # include <vector>
 # include <memory>
+# include <future>
 # include <core_utils/CoreObject.hh>
 # include <core_utils/TimeUtils.hh>
 # include "ChessGame.hh"
 # include "AI.hh"
+# include "Evaluator.hh"
+# include "Tablebase.hh"
+# include "Book.hh"
 
 namespace pge {
 
@@ -94,6 +98,15 @@ namespace pge {
       void
       togglePause();
 
+      /**
+       * @brief - Start or stop recording the events of the search
+       *          of the AI. Once started, each search of the AI is
+       *          saved to a file which can be decoded by the tool
+       *          `chess_tracedump`.
+       */
+      void
+      toggleTracing() noexcept;
+
       /**
        * @brief - Used to indicate that the world should be
        *          paused. Time based entities and actions
@@ -150,6 +163,15 @@ namespace pge {
       chess::Color
       getPlayer() const noexcept;
 
+      /**
+       * @brief - Returns the statistics of the last search of the
+       *          AI, if any.
+       * @param stats - output argument holding the statistics.
+       * @return - `true` if statistics are available.
+       */
+      bool
+      getSearchStats(chess::ai::SearchStats& stats) const noexcept;
+
       /**
        * @brief - Assigns the promotion to use when a pawn
        *          reaches the final row.
@@ -212,6 +234,64 @@ namespace pge {
       void
       enable(bool enable);
 
+      /**
+       * @brief - Start the search of the move of the AI on a
+       *          worker thread in case it is its turn to play.
+       *          The search runs on a snapshot of the game so
+       *          that the UI stays responsive: the move is then
+       *          applied by `updateAI`. Nothing happens if a
+       *          search is already running. In case the AI was
+       *          pondering, the search is either kept or stopped
+       *          depending on the move of the player.
+       */
+      void
+      think() noexcept;
+
+      /**
+       * @brief - Start searching the position reached after the
+       *          move the AI expects from the player, while the
+       *          player is thinking. In case the player makes
+       *          this move the search is used to answer, and it
+       *          is discarded otherwise.
+       */
+      void
+      ponder() noexcept;
+
+      /**
+       * @brief - Start the search of the AI in the input game on
+       *          a worker thread.
+       * @param game - the game to search, which is copied.
+       */
+      void
+      search(const chess::ChessGame& game) noexcept;
+
+      /**
+       * @brief - Apply the move of the AI to the game in case
+       *          the search running on the worker thread is
+       *          finished and start pondering. Does nothing
+       *          otherwise.
+       */
+      void
+      updateAI() noexcept;
+
+      /**
+       * @brief - Stop the search of the AI and discard its result.
+       *          This is used when the game is reset while the AI
+       *          is thinking or when the player did not make the
+       *          expected move.
+       */
+      void
+      cancelAI() noexcept;
+
+      /**
+       * @brief - Load the neural network used by the AI to
+       *          evaluate positions if it exists.
+       * @return - the evaluator using the network or null if
+       *           it does not exist or can't be loaded.
+       */
+      chess::ai::EvaluatorShPtr
+      loadEvaluator() noexcept;
+
       /**
        * @brief - Used during the step function and by any process
        *          that needs to update the UI and the text content
@@ -293,6 +373,15 @@ namespace pge {
         bool done;
       };
 
+      /// @brief - The move picked by the AI on the worker thread.
+      struct Thinking {
+        // Whether a valid move could be found.
+        bool valid;
+
+        // The move to play.
+        chess::ai::Move move;
+      };
+
       /// @brief - Convenience structure allowing to group information
       /// about a timed menu.
       struct TimedMenu {
@@ -395,12 +484,55 @@ namespace pge {
        */
       chess::CoordinatesShPtr m_promote;
 
+      /**
+       * @brief - The evaluation used by the AI, shared by all
+       *          the AIs created during the game. Null if the
+       *          default evaluation of the AI is used.
+       */
+      chess::ai::EvaluatorShPtr m_evaluator;
+
+      /**
+       * @brief - The endgame tables probed by the AI, shared by
+       *          all the AIs created during the game.
+       */
+      chess::ai::TablebaseShPtr m_tablebase;
+
+      /**
+       * @brief - The opening book used by the AI, shared by all
+       *          the AIs created during the game.
+       */
+      chess::ai::BookShPtr m_book;
+
       /**
        * @brief - The AI used to play the other color compared
        *          to what the user chose.
        */
       chess::AIShPtr m_ai;
 
+      /**
+       * @brief - The result of the search of the AI running on
+       *          a worker thread. Not valid when the AI is not
+       *          thinking.
+       */
+      std::future<Thinking> m_thinking;
+
+      /**
+       * @brief - Whether the search of the AI is running on the
+       *          time of the player.
+       */
+      bool m_pondering;
+
+      /**
+       * @brief - The key of the position searched while pondering.
+       */
+      chess::Key m_ponderKey;
+
+      /**
+       * @brief - Whether the events of the search of the AI are
+       *          recorded.
+       */
+      bool m_tracing;
+
       /**
        * @brief - The menus registered to display information to
        *          the user about the current state of the game.
@@ -59,6 +59,12 @@ namespace pge {
     return m_ai->side() == chess::Color::White ? chess::Color::Black : chess::Color::White;
   }
 
+  inline
+  bool
+  Game::getSearchStats(chess::ai::SearchStats& stats) const noexcept {
+    return m_ai->searchStats(stats);
+  }
+
 }
 
 #endif    /* GAME_HXX */
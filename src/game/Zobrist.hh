@@ -0,0 +1,63 @@
+#ifndef    ZOBRIST_HH
+# define   ZOBRIST_HH
+
+# include <cstdint>
+# include "Piece.hh"
+
+namespace chess {
+
+  /// @brief - The key identifying a position. Positions with
+  /// the same key are the same with a very high probability.
+  using Key = std::uint64_t;
+
+  namespace zobrist {
+
+    /// @brief - The castling rights are packed in four bits:
+    /// these values define the bit of each right.
+    enum Castling {
+      WhiteKingSide = 1,
+      WhiteQueenSide = 2,
+      BlackKingSide = 4,
+      BlackQueenSide = 8
+    };
+
+    /**
+     * @brief - Returns the key of a piece on a cell.
+     * @param c - the color of the piece.
+     * @param t - the type of the piece. Should not be `None`.
+     * @param id - the linear index of the cell.
+     * @return - the key for this piece.
+     */
+    Key
+    piece(const Color& c, const Type& t, int id) noexcept;
+
+    /**
+     * @brief - Returns the key used when black is to move.
+     * @return - the key for the side to move.
+     */
+    Key
+    side() noexcept;
+
+    /**
+     * @brief - Returns the key of a set of castling rights.
+     * @param rights - the rights, as a combination of the values
+     *                 of the `Castling` enumeration.
+     * @return - the key for these rights.
+     */
+    Key
+    castling(unsigned rights) noexcept;
+
+    /**
+     * @brief - Returns the key of the file of an en passant cell.
+     * @param file - the file of the cell, between 0 and 7.
+     * @return - the key for this file.
+     */
+    Key
+    enPassant(int file) noexcept;
+
+  }
+}
+
+# include "Zobrist.hxx"
+
+#endif    /* ZOBRIST_HH */
@@ -0,0 +1,105 @@
+#ifndef    ZOBRIST_HXX
+# define   ZOBRIST_HXX
+
+# include "Zobrist.hh"
+# include <array>
+
+namespace chess {
+  namespace zobrist {
+    namespace details {
+
+      /// @brief - The random values combined to build the key
+      /// of a position.
+      struct Tables {
+        // One key per piece and cell, indexed by the color, the
+        // type of the piece and the cell.
+        std::array<std::array<std::array<Key, 64u>, 6u>, 2u> pieces;
+
+        // The key toggled when black is to move.
+        Key side;
+
+        // One key per combination of castling rights.
+        std::array<Key, 16u> castling;
+
+        // One key per file of the en passant cell.
+        std::array<Key, 8u> enPassant;
+      };
+
+      /// @brief - Pseudo-random generator producing well spread
+      /// values from a state. See:
+      /// https://prng.di.unimi.it/splitmix64.c
+      constexpr
+      Key
+      splitmix64(Key& state) noexcept {
+        state += 0x9e3779b97f4a7c15ull;
+
+        Key z = state;
+        z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+
+        return z ^ (z >> 31u);
+      }
+
+      constexpr
+      Tables
+      generateTables() noexcept {
+        Tables t{};
+        Key state = 0x2545f4914f6cdd1dull;
+
+        for (unsigned c = 0u ; c < 2u ; ++c) {
+          for (unsigned p = 0u ; p < 6u ; ++p) {
+            for (unsigned id = 0u ; id < 64u ; ++id) {
+              t.pieces[c][p][id] = splitmix64(state);
+            }
+          }
+        }
+
+        t.side = splitmix64(state);
+
+        // No castling rights do not change the key so that an
+        // empty board has a null key.
+        for (unsigned id = 1u ; id < 16u ; ++id) {
+          t.castling[id] = splitmix64(state);
+        }
+
+        for (unsigned id = 0u ; id < 8u ; ++id) {
+          t.enPassant[id] = splitmix64(state);
+        }
+
+        return t;
+      }
+
+      /// @brief - The keys are computed at compile time so that
+      /// they are the same for all runs.
+      inline constexpr Tables TABLES = generateTables();
+
+    }
+
+    inline
+    Key
+    piece(const Color& c, const Type& t, int id) noexcept {
+      return details::TABLES.pieces[c == Color::White ? 0u : 1u][static_cast<unsigned>(t)][id];
+    }
+
+    inline
+    Key
+    side() noexcept {
+      return details::TABLES.side;
+    }
+
+    inline
+    Key
+    castling(unsigned rights) noexcept {
+      return details::TABLES.castling[rights];
+    }
+
+    inline
+    Key
+    enPassant(int file) noexcept {
+      return details::TABLES.enPassant[file];
+    }
+
+  }
+}
+
+#endif    /* ZOBRIST_HXX */
@@ -5,10 +5,14 @@
 namespace chess {
 
   AI::AI(const Color& color,
-         const std::string& name):
+         const std::string& name,
+         ai::BookShPtr book,
+         const ai::BookSettings& settings):
     utils::CoreObject(name),
 
-    m_color(color)
+    m_color(color),
+    m_book(book),
+    m_bookSettings(settings)
   {
     setService("ai");
   }
@@ -20,25 +24,44 @@ namespace chess {
 
   bool
   AI::play(ChessGame& b) noexcept {
-    // Make sure that the current player is the one
-    // assigned to the player.
-    Round r = b.getCurrentRound();
-
-    if (r.whitePlayed() && m_color == Color::White) {
-      // Skip as white already played.
+    ai::Move best;
+    if (!pick(b, best)) {
       return false;
     }
-    if (!r.whitePlayed() && m_color == Color::Black) {
-      // Skip as white still didn't play.
+
+    return apply(b, best);
+  }
+
+  bool
+  AI::pick(const ChessGame& b, ai::Move& best) noexcept {
+    // Make sure that the current player is the one
+    // assigned to the player. Note that this does not
+    // rely on the rounds as the game might start from
+    // a position where black plays first.
+    if (b.getPlayer() != m_color) {
       return false;
     }
-    if (r.whitePlayed() && r.blackPlayed() && m_color == Color::Black) {
-      // Skip as black already played.
+
+    // The current player does not change once the game
+    // is over: prevent playing after a checkmate.
+    if (b.isInCheckmate(oppositeColor(m_color))) {
       return false;
     }
 
+    // Known openings don't need to be analyzed: rounds are
+    // numbered from 0.
+    if (m_book != nullptr &&
+        b.getCurrentRound().id() < m_bookSettings.depth &&
+        m_book->probe(b(), m_color, m_bookSettings.randomness, best))
+    {
+      info("Picked move from " + best.start.toString() + " to " + best.end.toString() + " in opening book");
+      pickedFromBook(best);
+
+      return true;
+    }
+
     // Generate the best move using the interface method.
-    std::vector<ai::Move> moves = generateMoves(b());
+    ai::MoveList moves = generateMoves(b());
     if (moves.empty()) {
       debug("No legal moves for " + colorToString(m_color));
       return false;
@@ -46,8 +69,9 @@ namespace chess {
 
     debug("Generated " + std::to_string(moves.size()) + " move(s) for " + colorToString(m_color));
 
-    // Sort moves based on how favourable they are.
-    std::sort(
+    // Sort moves based on how favourable they are. The order
+    // of the AI is kept for moves with the same weight.
+    std::stable_sort(
       moves.begin(),
       moves.end(),
       [](const ai::Move& lhs, const ai::Move& rhs) {
@@ -55,25 +79,50 @@ namespace chess {
       }
     );
 
-    ai::Move best = moves[0];
+    best = moves[0];
     info("Picked move from " + best.start.toString() + " to " + best.end.toString() + " with weight " + std::to_string(best.weight));
 
-    // Apply the move.
+    return true;
+  }
+
+  bool
+  AI::apply(ChessGame& b, const ai::Move& best) noexcept {
     if (!b.move(best.start, best.end)) {
       warn("Failed to apply move from " + best.start.toString() + " to " + best.end.toString() + " picked by AI");
       return false;
     }
 
-    // Handle pawn promotion to queen as default.
-    if (best.end.y() == 0 || best.end.y() == b().h() - 1) {
-      const Piece& p = b().at(best.end);
-      if (p.pawn()) {
-        // For now, we always promote to a queen.
-        b.promote(best.end, Type::Queen);
-      }
+    // Handle pawn promotion.
+    if (best.promotion != Type::None) {
+      b.promote(best.end, best.promotion);
     }
 
     return true;
   }
 
+  bool
+  AI::expectedReply(ai::Move& /*reply*/) const noexcept {
+    return false;
+  }
+
+  void
+  AI::ponder() noexcept {}
+
+  void
+  AI::ponderHit() noexcept {}
+
+  void
+  AI::stop() noexcept {}
+
+  bool
+  AI::searchStats(ai::SearchStats& /*stats*/) const noexcept {
+    return false;
+  }
+
+  void
+  AI::trace(const std::string& /*file*/) noexcept {}
+
+  void
+  AI::pickedFromBook(const ai::Move& /*best*/) noexcept {}
+
 }
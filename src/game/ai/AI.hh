@@ -2,9 +2,11 @@
 # define   AI_HH
 
 # include <memory>
+# include <string>
 # include <core_utils/CoreObject.hh>
 # include "ChessGame.hh"
 # include "Types.hh"
+# include "Book.hh"
 
 namespace chess {
 
@@ -16,9 +18,15 @@ namespace chess {
        *          color.
        * @param color - the color the AI should play.
        * @param name - the name of the AI.
+       * @param book - the opening book, used to pick the move
+       *               without generating the moves as long as
+       *               the position is in it. May be null.
+       * @param settings - how the opening book is used.
        */
       AI(const Color& color,
-         const std::string& name);
+         const std::string& name,
+         ai::BookShPtr book = nullptr,
+         const ai::BookSettings& settings = ai::BookSettings{0u, 0.0f});
 
       /**
        * @brief - Return the side for which this AI is playing.
@@ -38,6 +46,95 @@ namespace chess {
       bool
       play(ChessGame& b) noexcept;
 
+      /**
+       * @brief - Pick the best move for the AI without applying
+       *          it. As the game is not modified this can be run
+       *          on a copy of the game in a separate thread, the
+       *          move being applied later on with `apply`.
+       *          Only one move can be picked at a time.
+       * @param b - the game to analyze.
+       * @param best - output argument holding the best move.
+       * @return - whether a valid move could be found.
+       */
+      bool
+      pick(const ChessGame& b, ai::Move& best) noexcept;
+
+      /**
+       * @brief - Apply a move picked by the AI to the game,
+       *          including the promotion if any.
+       * @param b - the game on which the move is played.
+       * @param best - the move to apply.
+       * @return - whether the move could be applied.
+       */
+      bool
+      apply(ChessGame& b, const ai::Move& best) noexcept;
+
+      /**
+       * @brief - Returns the move the AI expects the opponent to
+       *          play after the last move it picked. By default
+       *          the AI does not have any expectation.
+       * @param reply - output argument holding the expected move.
+       * @return - `true` if an expected move is available.
+       */
+      virtual
+      bool
+      expectedReply(ai::Move& reply) const noexcept;
+
+      /**
+       * @brief - Prepare the next call to `pick` to run on the
+       *          time of the opponent: it should search until it
+       *          is either told that the opponent played the
+       *          expected move through `ponderHit` or stopped.
+       *          Should be called before the search is started.
+       *          By default this does nothing.
+       */
+      virtual
+      void
+      ponder() noexcept;
+
+      /**
+       * @brief - Indicate that the opponent played the expected
+       *          move: the running search now uses its regular
+       *          budget. By default this does nothing.
+       */
+      virtual
+      void
+      ponderHit() noexcept;
+
+      /**
+       * @brief - Request the running search to stop as soon as
+       *          possible. Its result should not be used. By
+       *          default this does nothing.
+       */
+      virtual
+      void
+      stop() noexcept;
+
+      /**
+       * @brief - Returns the statistics of the last search run by
+       *          the AI. Can be called while the AI is searching
+       *          in another thread. By default the AI does not
+       *          provide any statistics.
+       * @param stats - output argument holding the statistics.
+       * @return - `true` if statistics are available.
+       */
+      virtual
+      bool
+      searchStats(ai::SearchStats& stats) const noexcept;
+
+      /**
+       * @brief - Record the events of the next searches and save
+       *          them to the input file at the end of each search,
+       *          or stop recording if the file is empty. Can be
+       *          called while the AI is searching in another
+       *          thread: it applies to the next search. By default
+       *          this does nothing.
+       * @param file - the file receiving the events.
+       */
+      virtual
+      void
+      trace(const std::string& file) noexcept;
+
     protected:
 
       /**
@@ -56,15 +153,35 @@ namespace chess {
        *           we just expect all weights to be available.
        */
       virtual
-      std::vector<ai::Move>
+      ai::MoveList
       generateMoves(const Board& b) noexcept = 0;
 
+      /**
+       * @brief - Called when the move was picked from the opening
+       *          book, in which case `generateMoves` is not called.
+       *          By default this does nothing.
+       * @param best - the move picked.
+       */
+      virtual
+      void
+      pickedFromBook(const ai::Move& best) noexcept;
+
     protected:
 
       /**
        * @brief - The color the AI is playing.
        */
       Color m_color;
+
+      /**
+       * @brief - The opening book, null if there is none.
+       */
+      ai::BookShPtr m_book;
+
+      /**
+       * @brief - How the opening book is used.
+       */
+      ai::BookSettings m_bookSettings;
   };
 
   using AIShPtr = std::shared_ptr<AI>;
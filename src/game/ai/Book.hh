@@ -0,0 +1,139 @@
+#ifndef    BOOK_HH
+# define   BOOK_HH
+
+# include <memory>
+# include <string>
+# include <core_utils/CoreObject.hh>
+# include "Zobrist.hh"
+# include "Types.hh"
+
+/// @brief - The size in bytes of an entry of a book in the
+/// Polyglot format.
+# define BOOK_ENTRY_SIZE 16u
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - An opening book in the Polyglot format: see
+    /// http://hgm.nubati.net/book_format.html
+    /// The file is a list of entries sorted by the key of the
+    /// position they apply to, each one describing a move and
+    /// its weight. The file is mapped in memory and searched
+    /// in place so that opening the book costs nothing.
+    class Book: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Map the input book. In case the file does
+         *          not exist or is invalid the book is empty.
+         * @param file - the path to the book.
+         */
+        Book(const std::string& file);
+
+        ~Book();
+
+        Book(const Book&) = delete;
+
+        Book&
+        operator=(const Book&) = delete;
+
+        /**
+         * @brief - Returns the number of entries of the book.
+         * @return - the number of entries.
+         */
+        unsigned
+        size() const noexcept;
+
+        /**
+         * @brief - Computes the key of a position as defined by
+         *          the Polyglot format. It is different from the
+         *          key maintained by the board.
+         * @param b - the board.
+         * @param side - the side to move.
+         * @return - the key of the position.
+         */
+        static
+        Key
+        key(const Board& b, const Color& side) noexcept;
+
+        /**
+         * @brief - Pick one of the moves of the book for the input
+         *          position, based on their weights.
+         * @param b - the board.
+         * @param side - the side to move.
+         * @param randomness - between `0` to always pick the move
+         *                     with the highest weight and `1` to
+         *                     pick moves with a probability equal
+         *                     to their share of the total weight.
+         * @param move - output argument receiving the move.
+         * @return - `true` if the position is in the book.
+         */
+        bool
+        probe(const Board& b,
+              const Color& side,
+              float randomness,
+              Move& move) const noexcept;
+
+      private:
+
+        /// @brief - An entry of the book, converted from the
+        /// big endian representation of the file.
+        struct Entry {
+          // The key of the position.
+          Key key;
+
+          // The move, packed as described by the format.
+          std::uint16_t move;
+
+          // The weight of the move.
+          std::uint16_t weight;
+        };
+
+        /**
+         * @brief - Read the entry at the input index.
+         * @param id - the index of the entry.
+         * @return - the entry.
+         */
+        Entry
+        entry(unsigned id) const noexcept;
+
+        /**
+         * @brief - Find the legal move matching a move of the book.
+         * @param b - the board.
+         * @param moves - the legal moves of the position.
+         * @param packed - the move of the book.
+         * @param move - output argument receiving the legal move.
+         * @return - `true` if the move is legal.
+         */
+        static
+        bool
+        convert(const Board& b,
+                const MoveList& moves,
+                std::uint16_t packed,
+                Move& move) noexcept;
+
+      private:
+
+        /**
+         * @brief - The start of the mapping, null if the book is
+         *          empty.
+         */
+        void* m_data;
+
+        /**
+         * @brief - The size of the mapping in bytes.
+         */
+        std::size_t m_bytes;
+
+        /**
+         * @brief - The number of entries of the book.
+         */
+        unsigned m_size;
+    };
+
+    using BookShPtr = std::shared_ptr<const Book>;
+
+  }
+}
+
+#endif    /* BOOK_HH */
@@ -0,0 +1,267 @@
+
+# include "Endgame.hh"
+# include <array>
+# include <algorithm>
+# include "Board.hh"
+
+namespace {
+
+  /// @brief - The types of the pieces other than the king from
+  /// the most to the least valuable.
+  const chess::Type TYPES[] = {
+    chess::Type::Queen,
+    chess::Type::Rook,
+    chess::Type::Bishop,
+    chess::Type::Knight,
+    chess::Type::Pawn
+  };
+
+  char
+  letter(const chess::Type& t) noexcept {
+    switch (t) {
+      case chess::Type::Queen:
+        return 'Q';
+      case chess::Type::Rook:
+        return 'R';
+      case chess::Type::Bishop:
+        return 'B';
+      case chess::Type::Knight:
+        return 'N';
+      case chess::Type::Pawn:
+        return 'P';
+      default:
+        return 'K';
+    }
+  }
+
+  unsigned
+  shift(unsigned color, const chess::Type& t) noexcept {
+    return 2u * (color * 5u + static_cast<unsigned>(t));
+  }
+
+  unsigned
+  pawns(const std::vector<chess::Type>& pieces) noexcept {
+    return static_cast<unsigned>(std::count(pieces.begin(), pieces.end(), chess::Type::Pawn));
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    Endgame::Endgame(const std::vector<Type>& strong, const std::vector<Type>& weak):
+      m_strong(strong),
+      m_weak(weak),
+      m_pawns(false),
+      m_name(),
+      m_material(0u),
+      m_size(0u)
+    {
+      auto valuable = [](const Type& lhs, const Type& rhs) {
+        return static_cast<unsigned>(lhs) > static_cast<unsigned>(rhs);
+      };
+
+      std::sort(m_strong.begin(), m_strong.end(), valuable);
+      std::sort(m_weak.begin(), m_weak.end(), valuable);
+
+      m_pawns = (pawns(m_strong) + pawns(m_weak) > 0u);
+
+      // The white king is restricted to a quarter of the board
+      // without pawns and to half of it otherwise.
+      m_size = 2u * (m_pawns ? 32u : 16u) * 64u;
+
+      m_name = "K";
+      for (unsigned id = 0u ; id < m_strong.size() ; ++id) {
+        m_name += letter(m_strong[id]);
+        m_material += (1u << shift(0u, m_strong[id]));
+        m_size *= (m_strong[id] == Type::Pawn ? 48u : 64u);
+      }
+
+      m_name += "vK";
+      for (unsigned id = 0u ; id < m_weak.size() ; ++id) {
+        m_name += letter(m_weak[id]);
+        m_material += (1u << shift(1u, m_weak[id]));
+        m_size *= (m_weak[id] == Type::Pawn ? 48u : 64u);
+      }
+    }
+
+    std::vector<Endgame>
+    Endgame::all() {
+      std::vector<Endgame> out;
+
+      // The strong side has the most valuable piece, or both
+      // pieces when the other side only has its king.
+      for (unsigned i = 0u ; i < 5u ; ++i) {
+        out.push_back(Endgame({TYPES[i]}, {}));
+      }
+
+      for (unsigned i = 0u ; i < 5u ; ++i) {
+        for (unsigned j = i ; j < 5u ; ++j) {
+          out.push_back(Endgame({TYPES[i], TYPES[j]}, {}));
+          out.push_back(Endgame({TYPES[i]}, {TYPES[j]}));
+        }
+      }
+
+      // Captures reduce the number of pieces and promotions
+      // the number of pawns.
+      std::stable_sort(
+        out.begin(),
+        out.end(),
+        [](const Endgame& lhs, const Endgame& rhs) {
+          std::size_t l = lhs.m_strong.size() + lhs.m_weak.size();
+          std::size_t r = rhs.m_strong.size() + rhs.m_weak.size();
+
+          if (l != r) {
+            return l < r;
+          }
+
+          return pawns(lhs.m_strong) + pawns(lhs.m_weak) < pawns(rhs.m_strong) + pawns(rhs.m_weak);
+        }
+      );
+
+      return out;
+    }
+
+    MaterialKey
+    Endgame::material(const Board& b, bool flip) noexcept {
+      MaterialKey key = 0u;
+
+      for (unsigned id = 0u ; id < 5u ; ++id) {
+        unsigned white = static_cast<unsigned>(bitboard::count(b.bitboard(Color::White, TYPES[id])));
+        unsigned black = static_cast<unsigned>(bitboard::count(b.bitboard(Color::Black, TYPES[id])));
+
+        key += (white << shift(flip ? 1u : 0u, TYPES[id]));
+        key += (black << shift(flip ? 0u : 1u, TYPES[id]));
+      }
+
+      return key;
+    }
+
+    const std::string&
+    Endgame::name() const noexcept {
+      return m_name;
+    }
+
+    MaterialKey
+    Endgame::material() const noexcept {
+      return m_material;
+    }
+
+    std::size_t
+    Endgame::size() const noexcept {
+      return m_size;
+    }
+
+    std::size_t
+    Endgame::index(const Board& b, const Color& side, bool flip) const noexcept {
+      Color white = (flip ? Color::Black : Color::White);
+      Color black = oppositeColor(white);
+      unsigned vertical = (flip ? 56u : 0u);
+
+      std::array<unsigned, TABLEBASE_MAX_PIECES> cells;
+      std::array<Type, TABLEBASE_MAX_PIECES> types;
+      unsigned count = 0u;
+
+      auto collect = [&](const Color& c, const std::vector<Type>& pieces) {
+        Bitboard remaining = 0u;
+
+        for (unsigned id = 0u ; id < pieces.size() ; ++id) {
+          // Pieces of the same type are taken in any order.
+          if (id == 0u || pieces[id] != pieces[id - 1u]) {
+            remaining = b.bitboard(c, pieces[id]);
+          }
+
+          cells[count] = static_cast<unsigned>(bitboard::pop(remaining)) ^ vertical;
+          types[count] = pieces[id];
+          ++count;
+        }
+      };
+
+      cells[0u] = static_cast<unsigned>(bitboard::first(b.bitboard(white, Type::King))) ^ vertical;
+      cells[1u] = static_cast<unsigned>(bitboard::first(b.bitboard(black, Type::King))) ^ vertical;
+      count = 2u;
+
+      collect(white, m_strong);
+      collect(black, m_weak);
+
+      unsigned mirror = (cells[0u] % 8u >= 4u ? 7u : 0u);
+      if (!m_pawns && (cells[0u] ^ mirror) / 8u >= 4u) {
+        mirror ^= 56u;
+      }
+
+      std::size_t out = ((flip ? oppositeColor(side) : side) == Color::White ? 0u : 1u);
+
+      unsigned king = cells[0u] ^ mirror;
+      out = out * (m_pawns ? 32u : 16u) + (king / 8u) * 4u + king % 8u;
+      out = out * 64u + (cells[1u] ^ mirror);
+
+      for (unsigned id = 2u ; id < count ; ++id) {
+        unsigned cell = cells[id] ^ mirror;
+
+        if (types[id] == Type::Pawn) {
+          out = out * 48u + cell - 8u;
+        }
+        else {
+          out = out * 64u + cell;
+        }
+      }
+
+      return out;
+    }
+
+    bool
+    Endgame::decode(std::size_t index, Board& b, Color& side) const {
+      std::array<unsigned, TABLEBASE_MAX_PIECES> cells;
+      std::array<Piece, TABLEBASE_MAX_PIECES> pieces;
+
+      unsigned count = 2u + static_cast<unsigned>(m_strong.size() + m_weak.size());
+
+      for (unsigned id = count - 1u ; id >= 2u ; --id) {
+        unsigned rank = id - 2u;
+        bool strong = (rank < m_strong.size());
+        const Type& t = (strong ? m_strong[rank] : m_weak[rank - m_strong.size()]);
+
+        pieces[id] = Piece::generate(t, strong ? Color::White : Color::Black);
+
+        if (t == Type::Pawn) {
+          cells[id] = static_cast<unsigned>(index % 48u) + 8u;
+          index /= 48u;
+        }
+        else {
+          cells[id] = static_cast<unsigned>(index % 64u);
+          index /= 64u;
+        }
+      }
+
+      cells[1u] = static_cast<unsigned>(index % 64u);
+      pieces[1u] = Piece::generate(Type::King, Color::Black);
+      index /= 64u;
+
+      unsigned kings = (m_pawns ? 32u : 16u);
+      unsigned king = static_cast<unsigned>(index % kings);
+      cells[0u] = (king / 4u) * 8u + king % 4u;
+      pieces[0u] = Piece::generate(Type::King, Color::White);
+      index /= kings;
+
+      side = (index == 0u ? Color::White : Color::Black);
+
+      Bitboard used = 0u;
+      for (unsigned id = 0u ; id < count ; ++id) {
+        Bitboard cell = bitboard::cell(static_cast<int>(cells[id]));
+        if ((used & cell) != 0u) {
+          return false;
+        }
+
+        used |= cell;
+      }
+
+      b.reset();
+      for (unsigned id = 0u ; id < count ; ++id) {
+        b.place(Coordinates(cells[id] % 8u, cells[id] / 8u), pieces[id]);
+      }
+
+      return true;
+    }
+
+  }
+}
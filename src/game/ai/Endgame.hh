@@ -0,0 +1,158 @@
+#ifndef    ENDGAME_HH
+# define   ENDGAME_HH
+
+# include <string>
+# include <vector>
+# include <cstdint>
+# include "Piece.hh"
+
+/// @brief - The maximum number of pieces, kings included, of
+/// the positions covered by the tablebases.
+# define TABLEBASE_MAX_PIECES 4u
+
+namespace chess {
+
+  /// @brief - Forward declaration of the board class to be
+  /// able to use it as an argument.
+  class Board;
+
+  namespace ai {
+
+    /// @brief - The material of a position, packed with two
+    /// bits counting the pieces of each type and color other
+    /// than the kings.
+    using MaterialKey = std::uint32_t;
+
+    /// @brief - Describes the positions of an endgame with a
+    /// given material and how they are indexed in its table.
+    /// The strong side plays white in the table: positions of
+    /// the same material with the colors swapped are flipped
+    /// vertically before being indexed.
+    /// As castling is not considered, the positions are also
+    /// mirrored so that the white king is on the queen side,
+    /// and in the lower half of the board when there are no
+    /// pawns. Pawns only use the 48 cells between the second
+    /// and seventh rank.
+    /// The index is made of, from the most significant to the
+    /// least significant: the side to move, the white king,
+    /// the black king, then the other white pieces and the
+    /// other black pieces from the most to the least valuable.
+    class Endgame {
+      public:
+
+        /**
+         * @brief - Create the endgame where the kings are joined
+         *          by the input pieces.
+         * @param strong - the pieces of the strong side, playing
+         *                 white in the table.
+         * @param weak - the pieces of the weak side.
+         */
+        Endgame(const std::vector<Type>& strong, const std::vector<Type>& weak);
+
+        /**
+         * @brief - Returns all the endgames with at most the
+         *          maximum number of pieces. They are ordered so
+         *          that the endgames reached by a capture or a
+         *          promotion come before the one they are reached
+         *          from.
+         * @return - the endgames.
+         */
+        static
+        std::vector<Endgame>
+        all();
+
+        /**
+         * @brief - Returns the key of the material of a board.
+         * @param b - the board.
+         * @param flip - whether the colors should be swapped.
+         * @return - the key of the material.
+         */
+        static
+        MaterialKey
+        material(const Board& b, bool flip) noexcept;
+
+        /**
+         * @brief - Returns the name of the endgame, such as `KQvKR`.
+         * @return - the name of the endgame.
+         */
+        const std::string&
+        name() const noexcept;
+
+        /**
+         * @brief - Returns the key of the material of the endgame.
+         * @return - the key of the material.
+         */
+        MaterialKey
+        material() const noexcept;
+
+        /**
+         * @brief - Returns the number of positions of the table,
+         *          including the invalid ones.
+         * @return - the size of the table.
+         */
+        std::size_t
+        size() const noexcept;
+
+        /**
+         * @brief - Computes the index of a position of the endgame.
+         *          The material of the board should be the one of
+         *          the endgame, with the colors swapped if needed.
+         * @param b - the board.
+         * @param side - the side to move.
+         * @param flip - whether the colors of the board should be
+         *               swapped to match the endgame.
+         * @return - the index of the position.
+         */
+        std::size_t
+        index(const Board& b, const Color& side, bool flip) const noexcept;
+
+        /**
+         * @brief - Setup the board with the position at the input
+         *          index. Nothing is placed in case pieces overlap.
+         *          The position can still be illegal.
+         * @param index - the index of the position.
+         * @param b - the board to setup.
+         * @param side - output argument receiving the side to move.
+         * @return - `false` if the pieces overlap.
+         */
+        bool
+        decode(std::size_t index, Board& b, Color& side) const;
+
+      private:
+
+        /**
+         * @brief - The pieces of the strong side, other than the
+         *          king, from the most to the least valuable.
+         */
+        std::vector<Type> m_strong;
+
+        /**
+         * @brief - The pieces of the weak side.
+         */
+        std::vector<Type> m_weak;
+
+        /**
+         * @brief - Whether the endgame has pawns.
+         */
+        bool m_pawns;
+
+        /**
+         * @brief - The name of the endgame.
+         */
+        std::string m_name;
+
+        /**
+         * @brief - The key of the material of the endgame.
+         */
+        MaterialKey m_material;
+
+        /**
+         * @brief - The number of positions of the table.
+         */
+        std::size_t m_size;
+    };
+
+  }
+}
+
+#endif    /* ENDGAME_HH */
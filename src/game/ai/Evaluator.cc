@@ -0,0 +1,29 @@
+
+# include "Evaluator.hh"
+
+namespace chess {
+  namespace ai {
+
+    Evaluator::~Evaluator() {}
+
+    std::unique_ptr<Evaluator>
+    PieceSquareEvaluator::clone() const {
+      return std::make_unique<PieceSquareEvaluator>();
+    }
+
+    void
+    PieceSquareEvaluator::reset(const Board& /*b*/) noexcept {}
+
+    void
+    PieceSquareEvaluator::push(const Board& /*b*/) noexcept {}
+
+    void
+    PieceSquareEvaluator::pop() noexcept {}
+
+    int
+    PieceSquareEvaluator::evaluate(const Color& c, const Board& b) noexcept {
+      return b.evaluate(c);
+    }
+
+  }
+}
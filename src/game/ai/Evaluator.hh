@@ -0,0 +1,94 @@
+#ifndef    EVALUATOR_HH
+# define   EVALUATOR_HH
+
+# include <memory>
+# include "Board.hh"
+
+namespace chess {
+  namespace ai {
+
+    class Evaluator;
+    using EvaluatorShPtr = std::shared_ptr<Evaluator>;
+
+    /// @brief - Interface of the static evaluation used at the
+    /// leaves of the search. The evaluator is told about each
+    /// move made and unmade on the board so that it can keep
+    /// its own information up to date incrementally.
+    class Evaluator {
+      public:
+
+        virtual ~Evaluator();
+
+        /**
+         * @brief - Create a new evaluator of the same kind, to be
+         *          used by another searcher. Read-only data can be
+         *          shared between the copies.
+         * @return - the new evaluator.
+         */
+        virtual
+        std::unique_ptr<Evaluator>
+        clone() const = 0;
+
+        /**
+         * @brief - Prepare the evaluation of the positions reached
+         *          from the input one, which is the root of a new
+         *          search.
+         * @param b - the position.
+         */
+        virtual
+        void
+        reset(const Board& b) noexcept = 0;
+
+        /**
+         * @brief - Called right after a move (or a null move) was
+         *          made on the board.
+         * @param b - the board after the move.
+         */
+        virtual
+        void
+        push(const Board& b) noexcept = 0;
+
+        /**
+         * @brief - Called right after the last move was unmade.
+         */
+        virtual
+        void
+        pop() noexcept = 0;
+
+        /**
+         * @brief - Evaluate the current position.
+         * @param c - the color for which the board is evaluated.
+         * @param b - the board.
+         * @return - the evaluation in centipawns from the point of
+         *           view of the input color.
+         */
+        virtual
+        int
+        evaluate(const Color& c, const Board& b) noexcept = 0;
+    };
+
+    /// @brief - The default evaluator, relying on the material
+    /// and piece-square scores maintained by the board.
+    class PieceSquareEvaluator: public Evaluator {
+      public:
+
+        std::unique_ptr<Evaluator>
+        clone() const override;
+
+        void
+        reset(const Board& b) noexcept override;
+
+        void
+        push(const Board& b) noexcept override;
+
+        void
+        pop() noexcept override;
+
+        int
+        evaluate(const Color& c, const Board& b) noexcept override;
+    };
+
+  }
+}
+
+#endif    /* EVALUATOR_HH */
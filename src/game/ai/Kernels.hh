@@ -0,0 +1,67 @@
+#ifndef    KERNELS_HH
+# define   KERNELS_HH
+
+# include <cstdint>
+
+namespace chess {
+  namespace ai {
+    namespace kernels {
+
+      /**
+       * @brief - Returns the name of the instruction set used by
+       *          the kernels. It is selected at compile time: AVX2
+       *          if available, then SSSE3 and finally a portable
+       *          scalar implementation.
+       * @return - the name of the instruction set.
+       */
+      const char*
+      instructions() noexcept;
+
+      /**
+       * @brief - Add the input values to the accumulator.
+       * @param acc - the accumulator.
+       * @param values - the values to add.
+       * @param n - the number of values, a multiple of 32.
+       */
+      void
+      add(std::int16_t* acc, const std::int16_t* values, unsigned n) noexcept;
+
+      /**
+       * @brief - Subtract the input values from the accumulator.
+       * @param acc - the accumulator.
+       * @param values - the values to subtract.
+       * @param n - the number of values, a multiple of 32.
+       */
+      void
+      sub(std::int16_t* acc, const std::int16_t* values, unsigned n) noexcept;
+
+      /**
+       * @brief - Clamp the input values between `0` and `127` and
+       *          store them as bytes.
+       * @param in - the values to clamp.
+       * @param out - the output bytes.
+       * @param n - the number of values, a multiple of 32.
+       */
+      void
+      clippedReLU(const std::int16_t* in, std::uint8_t* out, unsigned n) noexcept;
+
+      /**
+       * @brief - Computes the dot product of unsigned activations
+       *          with signed weights. As activations are at most
+       *          `127` the sum of two products fits in 16 bits,
+       *          which the vectorized versions rely on.
+       * @param in - the activations, between `0` and `127`.
+       * @param weights - the weights.
+       * @param n - the number of values, a multiple of 32.
+       * @return - the dot product.
+       */
+      std::int32_t
+      dot(const std::uint8_t* in, const std::int8_t* weights, unsigned n) noexcept;
+
+    }
+  }
+}
+
+# include "Kernels.hxx"
+
+#endif    /* KERNELS_HH */
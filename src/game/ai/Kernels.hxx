@@ -0,0 +1,164 @@
+#ifndef    KERNELS_HXX
+# define   KERNELS_HXX
+
+# include "Kernels.hh"
+
+# if defined(__AVX2__)
+#  include <immintrin.h>
+# elif defined(__SSSE3__)
+#  include <tmmintrin.h>
+# endif
+
+namespace chess {
+  namespace ai {
+    namespace kernels {
+
+      inline
+      const char*
+      instructions() noexcept {
+# if defined(__AVX2__)
+        return "AVX2";
+# elif defined(__SSSE3__)
+        return "SSSE3";
+# else
+        return "scalar";
+# endif
+      }
+
+      inline
+      void
+      add(std::int16_t* acc, const std::int16_t* values, unsigned n) noexcept {
+# if defined(__AVX2__)
+        for (unsigned id = 0u ; id < n ; id += 16u) {
+          __m256i* a = reinterpret_cast<__m256i*>(acc + id);
+          __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + id));
+          _mm256_storeu_si256(a, _mm256_add_epi16(_mm256_loadu_si256(a), v));
+        }
+# elif defined(__SSSE3__)
+        for (unsigned id = 0u ; id < n ; id += 8u) {
+          __m128i* a = reinterpret_cast<__m128i*>(acc + id);
+          __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + id));
+          _mm_storeu_si128(a, _mm_add_epi16(_mm_loadu_si128(a), v));
+        }
+# else
+        for (unsigned id = 0u ; id < n ; ++id) {
+          acc[id] += values[id];
+        }
+# endif
+      }
+
+      inline
+      void
+      sub(std::int16_t* acc, const std::int16_t* values, unsigned n) noexcept {
+# if defined(__AVX2__)
+        for (unsigned id = 0u ; id < n ; id += 16u) {
+          __m256i* a = reinterpret_cast<__m256i*>(acc + id);
+          __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + id));
+          _mm256_storeu_si256(a, _mm256_sub_epi16(_mm256_loadu_si256(a), v));
+        }
+# elif defined(__SSSE3__)
+        for (unsigned id = 0u ; id < n ; id += 8u) {
+          __m128i* a = reinterpret_cast<__m128i*>(acc + id);
+          __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + id));
+          _mm_storeu_si128(a, _mm_sub_epi16(_mm_loadu_si128(a), v));
+        }
+# else
+        for (unsigned id = 0u ; id < n ; ++id) {
+          acc[id] -= values[id];
+        }
+# endif
+      }
+
+      inline
+      void
+      clippedReLU(const std::int16_t* in, std::uint8_t* out, unsigned n) noexcept {
+# if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+
+        for (unsigned id = 0u ; id < n ; id += 32u) {
+          __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + id));
+          __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + id + 16u));
+
+          // The packing saturates to [-128, 127] and works on
+          // each 128 bits lane: the 64 bits blocks need to be
+          // put back in order.
+          __m256i packed = _mm256_max_epi8(_mm256_packs_epi16(lo, hi), zero);
+          packed = _mm256_permute4x64_epi64(packed, 0xd8);
+
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + id), packed);
+        }
+# elif defined(__SSSE3__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i max = _mm_set1_epi16(127);
+
+        for (unsigned id = 0u ; id < n ; id += 16u) {
+          __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + id));
+          __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + id + 8u));
+
+          lo = _mm_min_epi16(_mm_max_epi16(lo, zero), max);
+          hi = _mm_min_epi16(_mm_max_epi16(hi, zero), max);
+
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + id), _mm_packus_epi16(lo, hi));
+        }
+# else
+        for (unsigned id = 0u ; id < n ; ++id) {
+          std::int16_t v = in[id];
+          out[id] = static_cast<std::uint8_t>(v < 0 ? 0 : (v > 127 ? 127 : v));
+        }
+# endif
+      }
+
+      inline
+      std::int32_t
+      dot(const std::uint8_t* in, const std::int8_t* weights, unsigned n) noexcept {
+# if defined(__AVX2__)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned id = 0u ; id < n ; id += 32u) {
+          __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + id));
+          __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + id));
+
+          // Multiply bytes and add adjacent pairs to 16 bits,
+          // then add adjacent pairs again to 32 bits.
+          __m256i products = _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), ones);
+          sum = _mm256_add_epi32(sum, products);
+        }
+
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+
+        return _mm_cvtsi128_si32(s);
+# elif defined(__SSSE3__)
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i sum = _mm_setzero_si128();
+
+        for (unsigned id = 0u ; id < n ; id += 16u) {
+          __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + id));
+          __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + id));
+
+          __m128i products = _mm_madd_epi16(_mm_maddubs_epi16(a, w), ones);
+          sum = _mm_add_epi32(sum, products);
+        }
+
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+
+        return _mm_cvtsi128_si32(sum);
+# else
+        std::int32_t sum = 0;
+
+        for (unsigned id = 0u ; id < n ; ++id) {
+          sum += static_cast<std::int32_t>(in[id]) * weights[id];
+        }
+
+        return sum;
+# endif
+      }
+
+    }
+  }
+}
+
+#endif    /* KERNELS_HXX */
@@ -1,298 +1,307 @@
 
 # include "MinimaxAI.hh"
+# include <thread>
+# include <algorithm>
 # include <core_utils/Chrono.hh>
+# include <core_utils/CoreException.hh>
 # include "MoveGeneration.hh"
 
-/// @brief - Defines the evaluation of the checkmate position.
-/// This value should be high enough to not be mistaken for
-/// another position but small enough so that we can still be
-/// able to distinguish between faster mates.
-# define CHECKMATE_EVALUATION 32000
-
-/// @brief - Activate these logs to debug the AI.
-// # define PRE_ROOT_LOG
-// # define ROOT_LOG
-// # define EVALUATE_LOG
-// # define EXPLORE_LOG
-// # define SUMMARY_LOG
-
-namespace {
-
-  int
-  pieceValue(const chess::Piece& p) noexcept {
-    if (p.pawn()) {
-      return 10;
-    }
-    else if (p.knight()) {
-      return 30;
-    }
-    else if (p.bishop()) {
-      return 30;
-    }
-    else if (p.rook()) {
-      return 50;
-    }
-    else if (p.queen()) {
-      return 90;
-    }
-    else if (p.king()) {
-      return 900;
+namespace chess {
+
+  MinimaxAI::MinimaxAI(const Color& color,
+                       const ai::SearchLimits& limits,
+                       unsigned hashSizeMB,
+                       unsigned threads,
+                       const ai::Pruning& pruning,
+                       ai::EvaluatorShPtr evaluator,
+                       ai::TablebaseShPtr tablebase,
+                       ai::BookShPtr book,
+                       const ai::BookSettings& settings):
+    AI(color, "minimax", book, settings),
+    m_limits(limits),
+    m_table(hashSizeMB),
+    m_abort(false),
+    m_ponder(false),
+    m_searchers(),
+    m_statsLocker(),
+    m_searched(false),
+    m_stats(),
+    m_traceLocker(),
+    m_traceFile(),
+    m_tablebase(tablebase),
+    m_solved(false),
+    m_line()
+  {
+    if (evaluator == nullptr) {
+      evaluator = std::make_shared<ai::PieceSquareEvaluator>();
     }
-    else {
-      // No piece or invalid type, null value.
-      return 0;
+
+    for (unsigned id = 0u ; id < std::max(threads, 1u) ; ++id) {
+      m_searchers.push_back(
+        std::make_unique<ai::Searcher>(id, m_table, m_limits, pruning, m_abort, m_ponder, evaluator->clone(), m_tablebase)
+      );
     }
   }
 
-  int
-  evaluateBoard(const chess::Color& c,
-                const chess::Board& b) noexcept
-  {
-    int weight = 0;
+  const ai::MoveList&
+  MinimaxAI::principalVariation() const noexcept {
+    if (m_solved) {
+      return m_line;
+    }
 
-    // Traverse the board and evaluate it.
-    for (int y = 0 ; y < b.h() ; ++y) {
-      for (int x = 0 ; x < b.w() ; ++x) {
-        const chess::Piece& p = b.at(x, y);
-        int ev = pieceValue(p);
+    return m_searchers[0]->principalVariation();
+  }
 
-        weight += (p.color() == c ? ev : -ev);
-      }
+  bool
+  MinimaxAI::expectedReply(ai::Move& reply) const noexcept {
+    const ai::MoveList& line = principalVariation();
+    if (line.size() < 2u) {
+      return false;
     }
 
-    return weight;
+    reply = line[1];
+    return true;
   }
 
-}
+  void
+  MinimaxAI::ponder() noexcept {
+    m_abort.store(false);
+    m_ponder.store(true);
+  }
 
-namespace chess {
+  void
+  MinimaxAI::ponderHit() noexcept {
+    m_ponder.store(false);
+  }
 
-  MinimaxAI::MinimaxAI(const Color& color,
-                       unsigned depth):
-    AI(color, "minimax"),
-    m_depth(depth)
-  {}
+  void
+  MinimaxAI::stop() noexcept {
+    m_abort.store(true);
+  }
+
+  bool
+  MinimaxAI::searchStats(ai::SearchStats& stats) const noexcept {
+    const std::lock_guard<std::mutex> guard(m_statsLocker);
+
+    if (m_searched) {
+      stats = m_stats;
+    }
 
-  std::vector<ai::Move>
+    return m_searched;
+  }
+
+  void
+  MinimaxAI::trace(const std::string& file) noexcept {
+    const std::lock_guard<std::mutex> guard(m_traceLocker);
+    m_traceFile = file;
+  }
+
+  ai::MoveList
   MinimaxAI::generateMoves(const Board& b) noexcept {
     // The algorithm behind what is done here has been taken
     // from the following link:
     // https://www.freecodecamp.org/news/simple-chess-ai-step-by-step-1d55a9266977/
 
     // Generate moves.
-    std::vector<ai::Move> moves = ai::generate(m_color, b);
-    unsigned nodes = 0u;
-    unsigned pruned = 0u;
+    ai::MoveList moves = ai::generate(m_color, b);
 
-    // For each available position, evaluate the
-    // state of the board after making the move.
+    // Solved positions don't need to be searched.
+    m_solved = solve(b, moves);
+    if (m_solved) {
+      m_ponder.store(false);
+      return moves;
+    }
+
+    m_table.newSearch();
+
+    // Tracing is only changed between searches so that the
+    // searchers don't need to synchronize when recording.
+    std::string trace;
     {
-      utils::Chrono<> clock("Evaluation of " + std::to_string(moves.size()) + " move(s)", "moves");
-
-      int alpha = -CHECKMATE_EVALUATION;
-      int beta = CHECKMATE_EVALUATION;
-
-      for (unsigned id = 0u ; id < moves.size() ; ++id) {
-        // Apply the move and auto-promote to queen.
-        Board cb(b);
-        cb.move(moves[id].start, moves[id].end, true, Type::Queen);
-
-# ifdef PRE_ROOT_LOG
-        std::string msg = "Evaluating ";
-        msg += cb.at(moves[id].end).fullName();
-        msg += " from ";
-        msg += moves[id].start.toString();
-        msg += " to ";
-        msg += moves[id].end.toString();
-
-        notice("[0] " + colorToString(m_color) + " " + msg);
-# endif
-
-        // The idea of the alpha-beta pruning is described
-        // in the following link:
-        // https://en.wikipedia.org/wiki/Alpha%E2%80%93beta_pruning#Pseudocode
-        unsigned visited = 0u;
-        moves[id].weight = -evaluate(oppositeColor(m_color), cb, false, -beta, -alpha, 1u, &visited, &pruned);
-        nodes += visited;
-
-# ifdef ROOT_LOG
-#  ifdef PRE_ROOT_LOG
-        msg = "Evaluated ";
-#  else
-        std::string msg = "Evaluated ";
-#  endif
-        msg += cb.at(moves[id].end).fullName();
-        msg += " from ";
-        msg += moves[id].start.toString();
-        msg += " to ";
-        msg += moves[id].end.toString();
-        msg += " to ";
-        msg += std::to_string(moves[id].weight);
-        msg += " (nodes: ";
-        msg += std::to_string(visited);
-        msg += ", pruned: ";
-        msg += std::to_string(pruned);
-        msg += ")";
-
-        notice("[0] " + colorToString(m_color) + " " + msg);
-# endif
-        // Handle alpha-beta pruning.
-        alpha = std::max(alpha, moves[id].weight);
-      }
+      const std::lock_guard<std::mutex> guard(m_traceLocker);
+      trace = m_traceFile;
+    }
+
+    for (unsigned id = 0u ; id < m_searchers.size() ; ++id) {
+      m_searchers[id]->setTracing(!trace.empty());
+    }
+
+    // A pondering search may already have been stopped: the
+    // flag was cleared when it was prepared.
+    bool pondering = m_ponder.load();
+    if (!pondering) {
+      m_abort.store(false);
+    }
+
+    utils::TimeStamp start = utils::now();
+    utils::Chrono<> clock("Evaluation of " + std::to_string(moves.size()) + " move(s)", "moves");
+
+    // The helpers search the same position on their own copy
+    // of the moves: they only contribute through the entries
+    // they store in the table. Half of them start one ply
+    // deeper so that the threads don't all search the same
+    // nodes at the same time. Having the helpers skip whole
+    // iterations instead scales worse: they lose the move
+    // ordering of the iterations they skip.
+    std::vector<std::thread> helpers;
+    for (unsigned id = 1u ; id < m_searchers.size() ; ++id) {
+      helpers.emplace_back(
+        [this, id, &b, moves, start]() mutable {
+          m_searchers[id]->run(m_color, b, moves, start, 1u + id % 2u);
+        }
+      );
+    }
+
+    unsigned completed = m_searchers[0]->run(m_color, b, moves, start, 1u);
+
+    m_abort.store(true);
+    for (unsigned id = 0u ; id < helpers.size() ; ++id) {
+      helpers[id].join();
+    }
+
+    // The next search uses its budget unless told otherwise.
+    m_ponder.store(false);
+
+    std::uint64_t pruned = 0u;
+    ai::TableStats stats{0u, 0u, 0u, 0u};
+
+    ai::SearchStats search{};
+    search.depth = completed;
+    search.time = utils::diffInMs(start, utils::now());
+    search.iterations = m_searchers[0]->iterations();
+
+    for (unsigned id = 0u ; id < m_searchers.size() ; ++id) {
+      const ai::Searcher& s = *m_searchers[id];
+      const ai::TableStats& ts = s.stats();
+
+      search.nodes += s.nodes();
+      search.quiescence += s.quiescenceNodes();
+      search.cutoffs += s.cutoffs();
+      search.firstMoveCutoffs += s.firstMoveCutoffs();
+      pruned += s.pruned();
 
-      info("Visited " + std::to_string(nodes) + " node(s) (" + std::to_string(pruned) + " pruned) to analyze " + std::to_string(moves.size()) + " move(s)");
+      stats.probes += ts.probes;
+      stats.hits += ts.hits;
+      stats.stores += ts.stores;
+      stats.collisions += ts.collisions;
     }
 
+    search.probes = stats.probes;
+    search.hits = stats.hits;
+    search.nps = (search.time > 0.0f ? 1000.0f * search.nodes / search.time : 0.0f);
+
+    info(
+      "Visited " + std::to_string(search.nodes) + " node(s) (" + std::to_string(search.quiescence) + " quiescence, " +
+      std::to_string(pruned) + " pruned) to analyze " + std::to_string(moves.size()) + " move(s)" +
+      " at depth " + std::to_string(completed) + " with " + std::to_string(m_searchers.size()) + " thread(s)" +
+      (pondering ? " (pondering)" : "") +
+      ", " + std::to_string(static_cast<std::uint64_t>(search.nps)) + " node(s)/s" +
+      ", table: " + std::to_string(stats.hits) + "/" + std::to_string(stats.probes) + " hit(s), " +
+      std::to_string(stats.stores) + " store(s), " + std::to_string(stats.collisions) + " collision(s)"
+    );
+
+    if (!trace.empty()) {
+      saveTrace(trace);
+    }
+
+    const std::lock_guard<std::mutex> guard(m_statsLocker);
+    m_searched = true;
+    m_stats = search;
+
     return moves;
+  }
+
+  void
+  MinimaxAI::pickedFromBook(const ai::Move& best) noexcept {
+    // The book does not tell what the opponent will play so
+    // there is nothing to ponder on.
+    m_solved = true;
+    m_line.clear();
+    m_line.push_back(best);
 
+    m_ponder.store(false);
   }
 
-  int
-  MinimaxAI::evaluate(const Color& c,
-                      const Board& b,
-                      bool maximizing,
-                      int alpha,
-                      int beta,
-                      unsigned depth,
-                      unsigned* nodes,
-                      unsigned* pruned) const noexcept
-  {
-# if defined(EVALUATE_LOG) || defined(EXPLORE_LOG) || defined(SUMMARY_LOG)
-    auto indent = [](unsigned depth) {
-      return std::string(2u * depth, ' ');
-    };
+  bool
+  MinimaxAI::solve(const Board& b, ai::MoveList& moves) noexcept {
+    ai::TablebaseResult result;
+    if (m_tablebase == nullptr || moves.empty() || !m_tablebase->probe(b, m_color, result)) {
+      return false;
+    }
 
-    auto print = [this, &depth, &indent, &c](const std::string msg) {
-      notice(
-        "[" + std::to_string(depth) + "] " + indent(depth) +
-        colorToString(c) + " " + msg
-      );
+    // Weight each move by the position it leads to, and keep
+    // the best reply of the opponent to the best move so that
+    // it can ponder on it.
+    Board cb(b);
+    Color o = oppositeColor(m_color);
+
+    auto weight = [this, &cb](const Color& c, ai::MoveList& list) {
+      unsigned best = 0u;
+
+      for (unsigned id = 0u ; id < list.size() ; ++id) {
+        ai::TablebaseResult child;
+        UndoRecord r;
+
+        cb.makeMove(list[id].start, list[id].end, list[id].promotion, r);
+        bool found = m_tablebase->probe(cb, oppositeColor(c), child);
+        cb.unmakeMove(r);
+
+        if (!found) {
+          return -1;
+        }
+
+        list[id].weight = -ai::Tablebase::score(child, 1u);
+        if (list[id].weight > list[best].weight) {
+          best = id;
+        }
+      }
+
+      return static_cast<int>(best);
     };
-# endif
-
-    // Color represents the player that just moved and
-    // led to this state of the board.
-    // We want this person to be maximizing the score.
-    // Hence the opposite color is the minimizing player.
-    if (depth >= m_depth) {
-      // We reached the terminal evaluation, evaluate
-      // the board for the player that requested the
-      // call.
-      float w = evaluateBoard(c, b);
-# ifdef EVALUATE_LOG
-      print("board: " + std::to_string(w));
-# endif
-
-      *nodes = 1u;
-
-      return w;
+
+    int best = weight(m_color, moves);
+    if (best < 0) {
+      return false;
     }
 
-    // Generate moves for the current color.
-    std::vector<ai::Move> moves = ai::generate(c, b);
-
-    // For each available position, evaluate the
-    // state of the board after making the move.
-    for (unsigned id = 0u ; id < moves.size() ; ++id) {
-      Board cb(b);
-      // Allow auto-promotion to queen.
-      cb.move(moves[id].start, moves[id].end, true, Type::Queen);
-
-# ifdef EXPLORE_LOG
-      std::string msg = "Evaluating ";
-      msg += cb.at(moves[id].end).fullName();
-      msg += " from ";
-      msg += moves[id].start.toString();
-      msg += " to ";
-      msg += moves[id].end.toString();
-      print(msg);
-# endif
-
-      unsigned visited = 0u;
-
-      // The returned value represents the evaluation of the
-      // board and the best moves for the opponent. To obtain
-      // the valuation for us, we need to negate it. This is
-      // controlled by the maximizing value.
-      moves[id].weight = -evaluate(oppositeColor(c), cb, !maximizing, -beta, -alpha, depth + 1u, &visited, pruned);
-      *nodes += visited;
-
-# ifdef EXPLORE_LOG
-      msg = "Evaluated ";
-      msg += cb.at(moves[id].end).fullName();
-      msg += " from ";
-      msg += moves[id].start.toString();
-      msg += " to ";
-      msg += moves[id].end.toString();
-      msg += " to ";
-      msg += std::to_string(moves[id].weight);
-      msg += " (nodes: ";
-      msg += std::to_string(visited);
-      msg += ")";
-      print(msg);
-# endif
-
-      // Handle alpha-beta pruning.
-      alpha = std::max(alpha, moves[id].weight);
-      if (alpha >= beta) {
-        *pruned += moves.size() - id;
-        break;
-      }
+    m_line.clear();
+    m_line.push_back(moves[best]);
+
+    UndoRecord r;
+    cb.makeMove(moves[best].start, moves[best].end, moves[best].promotion, r);
+    ai::MoveList replies = ai::generate(o, cb);
+    int reply = (replies.empty() ? -1 : weight(o, replies));
+    if (reply >= 0) {
+      m_line.push_back(replies[reply]);
     }
 
-    // Sort the move in ascending or descending order
-    // based on whether we should minimize or maximize
-    // the score.
-    std::sort(
-      moves.begin(),
-      moves.end(),
-      [](const ai::Move& lhs, const ai::Move& rhs) {
-        return lhs.weight > rhs.weight;
-      }
+    info(
+      "Solved position with tablebases: " + std::string(result.outcome > 0 ? "win" : (result.outcome < 0 ? "loss" : "draw")) +
+      (result.outcome != 0 ? " in " + std::to_string(result.plies) + " ply(ies)" : "") +
+      ", " + std::to_string(moves.size()) + " move(s) weighted"
     );
 
-    // In case we don't have any legal moves, it means
-    // that we're either in stalemate or we can't get
-    // out of check.
-    if (moves.empty()) {
-      bool check = b.computeCheck(c);
-      bool stalemate = b.computeStalemate(c);
-
-      // We want to value checkmate with a very high
-      // value, but stalemate not that much. It also
-      // depends on whether we want to maximize or
-      // to minimize the baord evaluation.
-      // Note that to favour the moves that lead to
-      // a checkmate faster, we include the depth of
-      // the evaluation in the weight.
-      float w = CHECKMATE_EVALUATION - depth;
-      if (maximizing) {
-        w = -CHECKMATE_EVALUATION;
-      }
+    return true;
+  }
 
-      // In case of checkmate, reverse the values.
-      if (check && stalemate) {
-        w = -w;
+  void
+  MinimaxAI::saveTrace(const std::string& file) noexcept {
+    try {
+      std::vector<ai::ThreadTrace> threads;
+      std::uint64_t events = 0u;
+
+      for (unsigned id = 0u ; id < m_searchers.size() ; ++id) {
+        threads.push_back(m_searchers[id]->trace().snapshot(id));
+        events += threads.back().records.size();
       }
 
-      return w;
-    }
+      ai::TraceFile(file).save(threads);
 
-# ifdef SUMMARY_LOG
-    std::string msg = "Analyzed ";
-    msg += std::to_string(moves.size());
-    msg += " move(s)";
-    msg += ", after ";
-    msg += (maximizing ? "maximizing" : "minimizing");
-    msg += " best: ";
-    msg += std::to_string(moves[0].weight);
-    msg += " (nodes: ";
-    msg += std::to_string(*nodes);
-    msg += ")";
-    print(msg);
-# endif
-
-    return moves[0].weight;
+      info("Saved " + std::to_string(events) + " event(s) of the search to \"" + file + "\"");
+    }
+    catch (const utils::CoreException& e) {
+      warn("Failed to save trace of the search", e.what());
+    }
   }
 
 }
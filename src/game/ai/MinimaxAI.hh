@@ -1,7 +1,20 @@
 #ifndef    MINIMAX_AI_HH
 # define   MINIMAX_AI_HH
 
+# include <mutex>
+# include <atomic>
+# include <memory>
+# include <string>
+# include <vector>
 # include "AI.hh"
+# include "TranspositionTable.hh"
+# include "Searcher.hh"
+# include "Evaluator.hh"
+# include "Tablebase.hh"
+
+/// @brief - The default memory budget for the transposition
+/// table, in megabytes.
+# define DEFAULT_HASH_SIZE_MB 16u
 
 namespace chess {
 
@@ -10,12 +23,98 @@ namespace chess {
 
       /**
        * @brief - Create an AI playing moves based on a
-       *          min max algorithm.
+       *          min max algorithm. The search is deepened
+       *          one ply at a time until the budget is used.
        * @param color - the color the AI should play.
-       * @param depth - the depth considered by the AI.
+       * @param limits - the budget of each search.
+       * @param hashSizeMB - the memory budget of the transposition
+       *                     table in megabytes.
+       * @param threads - the number of threads searching at the
+       *                  same time. The helper threads search the
+       *                  same position and share the table with
+       *                  the main one, whose result is used.
+       * @param pruning - the selective techniques to use.
+       * @param evaluator - the static evaluation of positions. Each
+       *                    searcher uses its own copy. The material
+       *                    and piece-square evaluation of the board
+       *                    is used if it is null.
+       * @param tablebase - the tables of the solved endgames, used
+       *                    instead of searching the positions they
+       *                    cover. May be null.
+       * @param book - the opening book. May be null.
+       * @param settings - how the opening book is used.
        */
       MinimaxAI(const Color& color,
-                unsigned depth);
+                const ai::SearchLimits& limits,
+                unsigned hashSizeMB = DEFAULT_HASH_SIZE_MB,
+                unsigned threads = 1u,
+                const ai::Pruning& pruning = ai::Pruning{true, true, true, true},
+                ai::EvaluatorShPtr evaluator = nullptr,
+                ai::TablebaseShPtr tablebase = nullptr,
+                ai::BookShPtr book = nullptr,
+                const ai::BookSettings& settings = ai::BookSettings{0u, 0.0f});
+
+      /**
+       * @brief - Returns the expected line of play found by the
+       *          last complete iteration of the search, starting
+       *          with the move picked by the AI.
+       * @return - the principal variation.
+       */
+      const ai::MoveList&
+      principalVariation() const noexcept;
+
+      /**
+       * @brief - Returns the second move of the principal variation
+       *          of the last search if any.
+       * @param reply - output argument holding the expected move.
+       * @return - `true` if an expected move is available.
+       */
+      bool
+      expectedReply(ai::Move& reply) const noexcept override;
+
+      /**
+       * @brief - The next search ignores its budget until either
+       *          `ponderHit` or `stop` is called.
+       */
+      void
+      ponder() noexcept override;
+
+      /**
+       * @brief - The running search uses its budget again, which
+       *          includes the time already spent pondering: this
+       *          allows to answer right away in case the search
+       *          already ran for long enough.
+       */
+      void
+      ponderHit() noexcept override;
+
+      /**
+       * @brief - Abort the running search and its helpers. The
+       *          entries they stored in the table are kept.
+       */
+      void
+      stop() noexcept override;
+
+      /**
+       * @brief - Returns the statistics of the last search which
+       *          completed. Positions solved by the tablebases or
+       *          played from the book don't produce statistics.
+       * @param stats - output argument holding the statistics.
+       * @return - `true` if a search completed.
+       */
+      bool
+      searchStats(ai::SearchStats& stats) const noexcept override;
+
+      /**
+       * @brief - Record the events of all the searchers during the
+       *          next searches and save them to the input file once
+       *          each search is over. This is cheap enough to keep
+       *          the timing of the search meaningful.
+       * @param file - the file receiving the events, or an empty
+       *               string to stop recording.
+       */
+      void
+      trace(const std::string& file) noexcept override;
 
     protected:
 
@@ -27,50 +126,119 @@ namespace chess {
        * @return -  the sorted list of moves from the most favourable
        *            one to the least favourable one.
        */
-      std::vector<ai::Move>
+      ai::MoveList
       generateMoves(const Board& b) noexcept override;
 
+      /**
+       * @brief - The move of the book replaces the principal
+       *          variation and the next search uses its budget.
+       * @param best - the move picked.
+       */
+      void
+      pickedFromBook(const ai::Move& best) noexcept override;
+
     private:
 
       /**
-       * @brief - Evaluate the best move for the current depth by
-       *          generating more moves if needed and aggregating
-       *          the result.
-       *          We use a minimax approach with a alpha-beta to
-       *          prune suboptimal results.
-       * @param c - the color for which the move should be found.
-       * @param b - the current state of the board.
-       * @param maximizing - defines whether we should try to find
-       *                     the maximum or minimum score for this
-       *                     iteration.
-       * @param alpha - used for alpha-beta pruning, characterizes the
-       *                minimum score that the maximizing player is
-       *                assured of.
-       * @param beta - used for alpha beta pruning. Defines the
-       *               maximum score that the minimizing player is
-       *               assured of.
-       * @param depth - the current depth of the evaluation.
-       * @param nodes - information about how many nodes where visited.
-       * @param pruned - defines how many nodes where pruned.
-       * @return - the evaluation of the current state of the board
-       *           after all possible moves up until the input depth.
-       */
-      int
-      evaluate(const Color& c,
-               const Board& b,
-               bool maximizing,
-               int alpha,
-               int beta,
-               unsigned depth,
-               unsigned* nodes,
-               unsigned* pruned) const noexcept;
+       * @brief - Weight the moves with the tablebases in case the
+       *          position is covered by them, in which case there
+       *          is no need to search it. The best move is the one
+       *          leading to the fastest mate, or delaying the mate
+       *          as much as possible in a lost position.
+       * @param b - the position.
+       * @param moves - the moves available in the position.
+       * @return - `true` if the moves were weighted.
+       */
+      bool
+      solve(const Board& b, ai::MoveList& moves) noexcept;
+
+      /**
+       * @brief - Write the events recorded by the searchers during
+       *          the last search to the input file. Failures are
+       *          only reported.
+       * @param file - the file receiving the events.
+       */
+      void
+      saveTrace(const std::string& file) noexcept;
 
     private:
 
-      /***
-       * @brief - The depth to consider when generating possible moves.
+      /**
+       * @brief - The budget of each search.
+       */
+      ai::SearchLimits m_limits;
+
+      /**
+       * @brief - The cache of the positions already searched. It
+       *          is kept from one move to the next and shared by
+       *          all the searchers.
+       */
+      ai::TranspositionTable m_table;
+
+      /**
+       * @brief - Set by the main searcher when it is done so that
+       *          the helpers stop as well, or when the search is
+       *          stopped.
+       */
+      std::atomic<bool> m_abort;
+
+      /**
+       * @brief - Set while the search runs on the time of the
+       *          opponent and should ignore its budget.
+       */
+      std::atomic<bool> m_ponder;
+
+      /**
+       * @brief - The searchers, one per thread. The first one is
+       *          the main searcher and runs on the calling thread.
+       */
+      std::vector<std::unique_ptr<ai::Searcher>> m_searchers;
+
+      /**
+       * @brief - Protects the statistics of the last search, as
+       *          they are read from other threads.
+       */
+      mutable std::mutex m_statsLocker;
+
+      /**
+       * @brief - Whether a search completed already.
+       */
+      bool m_searched;
+
+      /**
+       * @brief - The statistics of the last search.
+       */
+      ai::SearchStats m_stats;
+
+      /**
+       * @brief - Protects the file receiving the events of the
+       *          search, as it is set from other threads.
+       */
+      std::mutex m_traceLocker;
+
+      /**
+       * @brief - The file receiving the events of the searches,
+       *          empty when they are not recorded.
+       */
+      std::string m_traceFile;
+
+      /**
+       * @brief - The tables of the solved endgames. May be null.
+       */
+      ai::TablebaseShPtr m_tablebase;
+
+      /**
+       * @brief - Whether the move in the last position was found
+       *          with the tablebases or the opening book rather
+       *          than searched.
+       */
+      bool m_solved;
+
+      /**
+       * @brief - The expected line of play in the last position
+       *          in case it was not searched.
        */
-      unsigned m_depth;
+      ai::MoveList m_line;
   };
 
 }
@@ -2,32 +2,296 @@
 # include "MoveGeneration.hh"
 # include "Board.hh"
 
+/// @brief - The cells of the first and last rows of the board.
+# define FIRST_ROW 0x00000000000000FFull
+# define LAST_ROW  0xFF00000000000000ull
+
+namespace {
+
+  inline
+  chess::Coordinates
+  coordinates(int id) noexcept {
+    return chess::Coordinates(id % 8, id / 8);
+  }
+
+  /**
+   * @brief - Returns the pieces of the input color attacking the
+   *          cell, assuming the board has the input occupancy.
+   *          Pieces which are not part of the occupancy are not
+   *          considered.
+   * @param b - the board.
+   * @param id - the linear index of the cell.
+   * @param by - the color of the attacking pieces.
+   * @param occupied - the occupancy to consider.
+   * @return - the cells of the attacking pieces.
+   */
+  chess::Bitboard
+  attackers(const chess::Board& b,
+            int id,
+            const chess::Color& by,
+            chess::Bitboard occupied) noexcept
+  {
+    using namespace chess;
+
+    Bitboard queens = b.bitboard(by, Type::Queen);
+    Bitboard out = 0u;
+
+    out |= bitboard::pawnAttacks(oppositeColor(by), id) & b.bitboard(by, Type::Pawn);
+    out |= bitboard::knightAttacks(id) & b.bitboard(by, Type::Knight);
+    out |= bitboard::kingAttacks(id) & b.bitboard(by, Type::King);
+    out |= bitboard::bishopAttacks(id, occupied) & (b.bitboard(by, Type::Bishop) | queens);
+    out |= bitboard::rookAttacks(id, occupied) & (b.bitboard(by, Type::Rook) | queens);
+
+    return out & occupied;
+  }
+
+  inline
+  void
+  add(chess::ai::MoveList& out,
+      int from,
+      int to,
+      const chess::Piece& p,
+      const chess::Piece& captured,
+      const chess::Type& promotion = chess::Type::None) noexcept
+  {
+    chess::ai::Move m = {
+      coordinates(from), // Starting position.
+      coordinates(to),   // End position.
+      p,                 // Moving piece.
+      captured,          // Captured piece.
+      promotion,         // Promotion.
+      0                  // Weight.
+    };
+
+    out.push_back(m);
+  }
+
+  void
+  addMoves(chess::ai::MoveList& out,
+           const chess::Board& b,
+           int from,
+           const chess::Piece& p,
+           chess::Bitboard targets) noexcept
+  {
+    while (targets != 0u) {
+      int to = chess::bitboard::pop(targets);
+      add(out, from, to, p, b.at(coordinates(to)));
+    }
+  }
+
+  void
+  addPawnMoves(chess::ai::MoveList& out,
+               const chess::Board& b,
+               int from,
+               const chess::Piece& p,
+               chess::Bitboard targets) noexcept
+  {
+    using namespace chess;
+
+    while (targets != 0u) {
+      int to = bitboard::pop(targets);
+      const Piece& captured = b.at(coordinates(to));
+
+      if ((bitboard::cell(to) & (FIRST_ROW | LAST_ROW)) == 0u) {
+        add(out, from, to, p, captured);
+        continue;
+      }
+
+      add(out, from, to, p, captured, Type::Queen);
+      add(out, from, to, p, captured, Type::Rook);
+      add(out, from, to, p, captured, Type::Bishop);
+      add(out, from, to, p, captured, Type::Knight);
+    }
+  }
+
+  void
+  addCastling(chess::ai::MoveList& out,
+              const chess::Board& b,
+              const chess::Color& side,
+              int king,
+              bool kingSide) noexcept
+  {
+    using namespace chess;
+
+    Coordinates k = coordinates(king);
+    Coordinates co(kingSide ? b.w() - 1 : 0, k.y());
+
+    const Piece& r = b.at(co);
+    if (!r.rook() || r.color() != side || b.hasMoved(co)) {
+      return;
+    }
+
+    // The cells between the king and the rook should be
+    // empty.
+    int rook = co.y() * 8 + co.x();
+    if ((bitboard::between(king, rook) & b.occupancy()) != 0u) {
+      return;
+    }
+
+    // None of the cells traversed by the king should be
+    // attacked: the king is already known to not be in
+    // check.
+    Color o = oppositeColor(side);
+    int dx = (kingSide ? 1 : -1);
+    Coordinates dest(kingSide ? b.w() - 2 : 2, k.y());
+
+    for (int x = k.x() + dx ; x != dest.x() + dx ; x += dx) {
+      if (b.isSquareAttacked(Coordinates(x, k.y()), o)) {
+        return;
+      }
+    }
+
+    add(out, king, dest.y() * 8 + dest.x(), b.at(k), Piece::generate());
+  }
+
+}
+
 namespace chess {
   namespace ai {
 
-    std::vector<Move>
-    generate(const Color& side, const Board& b) noexcept {
-      // Gather the list of pieces and generate all possible
-      // moves with a default weight.
-      Pieces pieces = b.pieces(side);
-      std::vector<Move> out;
+    MoveList
+    generate(const Color& side,
+             const Board& b,
+             bool captures) noexcept
+    {
+      MoveList out;
+
+      Color o = oppositeColor(side);
+      Bitboard own = b.occupancy(side);
+      Bitboard enemy = b.occupancy(o);
+      Bitboard occupied = own | enemy;
+
+      // Compute the pieces giving check and the pinned pieces
+      // of the side to move. The moves of the other pieces are
+      // restricted to the cells in `allowed`, which are the ones
+      // capturing the checking piece or blocking the check.
+      Bitboard kings = b.bitboard(side, Type::King);
+      int king = -1;
+
+      Bitboard checkers = 0u;
+      Bitboard pinned = 0u;
+      Bitboard allowed = ~Bitboard(0u);
+
+      // The cells the pieces can move to when only captures
+      // are requested. Pawns can also move to the last rows
+      // to promote.
+      Bitboard filter = ~Bitboard(0u);
+
+      if (kings != 0u) {
+        king = bitboard::first(kings);
+        checkers = attackers(b, king, o, occupied);
+      }
+
+      if (captures && checkers == 0u) {
+        filter = enemy;
+      }
+
+      Bitboard pawnFilter = filter | FIRST_ROW | LAST_ROW;
+
+      if (kings != 0u) {
+        Bitboard queens = b.bitboard(o, Type::Queen);
+        Bitboard snipers =
+          (bitboard::rookAttacks(king, 0u) & (b.bitboard(o, Type::Rook) | queens)) |
+          (bitboard::bishopAttacks(king, 0u) & (b.bitboard(o, Type::Bishop) | queens));
+
+        while (snipers != 0u) {
+          int s = bitboard::pop(snipers);
+          Bitboard blockers = bitboard::between(king, s) & occupied;
+
+          if (bitboard::count(blockers) == 1 && (blockers & own) != 0u) {
+            pinned |= blockers;
+          }
+        }
+
+        if (checkers != 0u) {
+          int c = bitboard::first(checkers);
+          allowed = checkers | bitboard::between(king, c);
+        }
+
+        // The king can go to any cell not attacked once it
+        // has moved: it should not be part of the occupancy
+        // as it would hide the cells behind it from sliders.
+        const Piece& p = b.at(coordinates(king));
+        Bitboard targets = bitboard::kingAttacks(king) & ~own & filter;
 
-      for (unsigned id = 0u ; id < pieces.size() ; ++id) {
-        CoordinatesSet av = pieces[id].first.reachable(pieces[id].second, b);
+        while (targets != 0u) {
+          int to = bitboard::pop(targets);
 
-        for (CoordinatesSet::const_iterator it = av.cbegin() ; it != av.cend() ; ++it) {
-          // Filter invalid moves.
-          if (b.leadsToCheck(pieces[id].second, *it)) {
-            continue;
+          if (attackers(b, to, o, occupied ^ kings) == 0u) {
+            add(out, king, to, p, b.at(coordinates(to)));
           }
+        }
+
+        // In case of double check, only the king can move.
+        if (bitboard::count(checkers) > 1) {
+          return out;
+        }
+
+        if (checkers == 0u && !captures && !b.hasMoved(coordinates(king))) {
+          addCastling(out, b, side, king, true);
+          addCastling(out, b, side, king, false);
+        }
+      }
+
+      int forward = (side == Color::White ? 8 : -8);
+      Bitboard initial = (side == Color::White ? FIRST_ROW << 8u : LAST_ROW >> 8u);
+      Bitboard ep = b.enPassant();
 
-          Move m = {
-            pieces[id].second, // Starting position.
-            *it,               // End position.
-            0                  // Weight.
-          };
+      Bitboard pieces = own & ~kings;
+      while (pieces != 0u) {
+        int from = bitboard::pop(pieces);
+        const Piece& p = b.at(coordinates(from));
 
-          out.push_back(m);
+        Bitboard mask = allowed;
+        if ((pinned & bitboard::cell(from)) != 0u) {
+          mask &= bitboard::line(king, from);
+        }
+
+        switch (p.type()) {
+          case Type::Pawn: {
+            Bitboard targets = bitboard::pawnAttacks(side, from) & enemy;
+
+            int to = from + forward;
+            if ((occupied & bitboard::cell(to)) == 0u) {
+              targets |= bitboard::cell(to);
+
+              int far = to + forward;
+              if ((bitboard::cell(from) & initial) != 0u && (occupied & bitboard::cell(far)) == 0u) {
+                targets |= bitboard::cell(far);
+              }
+            }
+
+            addPawnMoves(out, b, from, p, targets & mask & pawnFilter);
+
+            // En passant can reveal a check along the row
+            // of the pawns as two pieces leave it at once,
+            // which is not captured by the pins: we verify
+            // the position of the king after the move.
+            if ((bitboard::pawnAttacks(side, from) & ep) != 0u) {
+              to = bitboard::first(ep);
+              int captured = to - forward;
+
+              Bitboard after = (occupied ^ bitboard::cell(from) ^ bitboard::cell(captured)) | ep;
+              if (king < 0 || attackers(b, king, o, after) == 0u) {
+                add(out, from, to, p, b.at(coordinates(captured)));
+              }
+            }
+            break;
+          }
+          case Type::Knight:
+            addMoves(out, b, from, p, bitboard::knightAttacks(from) & ~own & mask & filter);
+            break;
+          case Type::Bishop:
+            addMoves(out, b, from, p, bitboard::bishopAttacks(from, occupied) & ~own & mask & filter);
+            break;
+          case Type::Rook:
+            addMoves(out, b, from, p, bitboard::rookAttacks(from, occupied) & ~own & mask & filter);
+            break;
+          case Type::Queen:
+            addMoves(out, b, from, p, bitboard::queenAttacks(from, occupied) & ~own & mask & filter);
+            break;
+          default:
+            break;
         }
       }
 
@@ -1,23 +1,31 @@
 #ifndef    MOVE_GENERATION_HH
 # define   MOVE_GENERATION_HH
 
-# include <vector>
 # include "Types.hh"
 
 namespace chess {
   namespace ai {
 
     /**
-     * @brief - Generate the list of moves available for the
-     *          input side based on the current state of the
-     *          board.
+     * @brief - Generate the list of legal moves available for
+     *          the input side based on the current state of the
+     *          board. The pieces giving check and the pinned
+     *          pieces are computed once so that no move needs
+     *          to be played to be validated.
+     *          Promotions generate one move per possible type.
      * @param side - the side for which the moves should be
      *               generated.
      * @param b - the current state of the board.
+     * @param captures - `true` to only generate the captures and
+     *                   the promotions. This is ignored when the
+     *                   side is in check: all evasions are then
+     *                   generated.
      * @return - the list of moves available to the side.
      */
-    std::vector<Move>
-    generate(const Color& side, const Board& b) noexcept;
+    MoveList
+    generate(const Color& side,
+             const Board& b,
+             bool captures = false) noexcept;
 
   }
 }
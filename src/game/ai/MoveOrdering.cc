@@ -0,0 +1,216 @@
+
+# include "MoveOrdering.hh"
+# include <algorithm>
+
+/// @brief - The ordering score of the move stored in the
+/// transposition table.
+# define HASH_MOVE_SCORE (1 << 30)
+
+/// @brief - The base ordering score of captures and queen
+/// promotions.
+# define CAPTURE_SCORE (1 << 28)
+
+/// @brief - The ordering score of the first killer move of
+/// a ply, the second one is just below it.
+# define KILLER_SCORE (1 << 27)
+
+/// @brief - The maximum value of a history entry: the table
+/// is halved when it is reached so that quiet moves always
+/// stay below the killers.
+# define HISTORY_MAX (1 << 20)
+
+namespace {
+
+  int
+  index(const chess::Coordinates& c) noexcept {
+    return c.y() * 8 + c.x();
+  }
+
+  unsigned
+  colorIndex(const chess::Color& c) noexcept {
+    return (c == chess::Color::White ? 0u : 1u);
+  }
+
+  /**
+   * @brief - Returns a value of the piece of the input type
+   *          used to order captures. The king is given the
+   *          highest value so that it is considered as the
+   *          most valuable attacker.
+   * @param t - the type of the piece.
+   * @return - the value of the piece.
+   */
+  int
+  orderValue(const chess::Type& t) noexcept {
+    switch (t) {
+      case chess::Type::Pawn:
+        return 1;
+      case chess::Type::Knight:
+      case chess::Type::Bishop:
+        return 3;
+      case chess::Type::Rook:
+        return 5;
+      case chess::Type::Queen:
+        return 9;
+      case chess::Type::King:
+        return 10;
+      default:
+        return 0;
+    }
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    MoveOrdering::MoveOrdering() noexcept:
+      m_killers(),
+      m_history()
+    {
+      for (unsigned ply = 0u ; ply < MAX_PLY ; ++ply) {
+        m_killers[ply][0] = Killer{-1, -1};
+        m_killers[ply][1] = Killer{-1, -1};
+      }
+
+      for (unsigned c = 0u ; c < 2u ; ++c) {
+        for (unsigned start = 0u ; start < 64u ; ++start) {
+          m_history[c][start].fill(0);
+        }
+      }
+    }
+
+    void
+    MoveOrdering::newSearch() noexcept {
+      for (unsigned ply = 0u ; ply < MAX_PLY ; ++ply) {
+        m_killers[ply][0] = Killer{-1, -1};
+        m_killers[ply][1] = Killer{-1, -1};
+      }
+
+      for (unsigned c = 0u ; c < 2u ; ++c) {
+        for (unsigned start = 0u ; start < 64u ; ++start) {
+          for (unsigned end = 0u ; end < 64u ; ++end) {
+            m_history[c][start][end] /= 2;
+          }
+        }
+      }
+    }
+
+    void
+    MoveOrdering::score(const Color& c,
+                        MoveList& moves,
+                        const HashEntry* hash,
+                        unsigned ply) const noexcept
+    {
+      const History& history = m_history[colorIndex(c)];
+      const Killer* killers = nullptr;
+      if (ply < MAX_PLY) {
+        killers = m_killers[ply].data();
+      }
+
+      for (unsigned id = 0u ; id < moves.size() ; ++id) {
+        Move& m = moves[id];
+        int start = index(m.start);
+        int end = index(m.end);
+
+        if (hash != nullptr &&
+            hash->start != hash->end &&
+            static_cast<int>(hash->start) == start &&
+            static_cast<int>(hash->end) == end &&
+            hash->promotion == m.promotion)
+        {
+          m.weight = HASH_MOVE_SCORE;
+        }
+        else if (m.captured.valid() || m.promotion == Type::Queen) {
+          // Most valuable victim first, and for the same victim
+          // the least valuable attacker first.
+          int victim = orderValue(m.captured.type());
+          if (m.promotion == Type::Queen) {
+            victim += orderValue(Type::Queen);
+          }
+
+          m.weight = CAPTURE_SCORE + 16 * victim - orderValue(m.piece.type());
+        }
+        else if (killers != nullptr && killers[0].start == start && killers[0].end == end) {
+          m.weight = KILLER_SCORE;
+        }
+        else if (killers != nullptr && killers[1].start == start && killers[1].end == end) {
+          m.weight = KILLER_SCORE - 1;
+        }
+        else {
+          m.weight = history[start][end];
+        }
+      }
+    }
+
+    void
+    MoveOrdering::pick(MoveList& moves, unsigned id) noexcept {
+      unsigned best = id;
+
+      for (unsigned next = id + 1u ; next < moves.size() ; ++next) {
+        if (moves[next].weight > moves[best].weight) {
+          best = next;
+        }
+      }
+
+      if (best != id) {
+        std::swap(moves[id], moves[best]);
+      }
+    }
+
+    void
+    MoveOrdering::cutoff(const Color& c,
+                         const Move& m,
+                         unsigned ply,
+                         unsigned depth) noexcept
+    {
+      if (m.captured.valid() || m.promotion != Type::None) {
+        return;
+      }
+
+      int start = index(m.start);
+      int end = index(m.end);
+
+      if (ply < MAX_PLY) {
+        std::array<Killer, 2u>& killers = m_killers[ply];
+
+        if (killers[0].start != start || killers[0].end != end) {
+          killers[1] = killers[0];
+          killers[0] = Killer{start, end};
+        }
+      }
+
+      // Deeper cutoffs are more significant.
+      History& history = m_history[colorIndex(c)];
+      history[start][end] += static_cast<int>(depth * depth);
+
+      if (history[start][end] >= HISTORY_MAX) {
+        for (unsigned from = 0u ; from < 64u ; ++from) {
+          for (unsigned to = 0u ; to < 64u ; ++to) {
+            history[from][to] /= 2;
+          }
+        }
+      }
+    }
+
+    bool
+    MoveOrdering::killer(const Move& m, unsigned ply) const noexcept {
+      if (ply >= MAX_PLY) {
+        return false;
+      }
+
+      int start = index(m.start);
+      int end = index(m.end);
+
+      const std::array<Killer, 2u>& killers = m_killers[ply];
+      return
+        (killers[0].start == start && killers[0].end == end) ||
+        (killers[1].start == start && killers[1].end == end);
+    }
+
+    int
+    MoveOrdering::history(const Color& c, const Move& m) const noexcept {
+      return m_history[colorIndex(c)][index(m.start)][index(m.end)];
+    }
+
+  }
+}
@@ -0,0 +1,127 @@
+#ifndef    MOVE_ORDERING_HH
+# define   MOVE_ORDERING_HH
+
+# include <array>
+# include "Types.hh"
+# include "TranspositionTable.hh"
+
+/// @brief - The maximum number of plies for which killer
+/// moves are kept.
+# define MAX_PLY 128u
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - Keeps track of the moves which produced cutoffs
+    /// during the search and uses them to sort the moves so that
+    /// the best ones are searched first.
+    class MoveOrdering {
+      public:
+
+        /**
+         * @brief - Create an empty ordering.
+         */
+        MoveOrdering() noexcept;
+
+        /**
+         * @brief - Prepare the ordering for a new search: killer
+         *          moves are forgotten and the history is aged so
+         *          that recent cutoffs weigh more.
+         */
+        void
+        newSearch() noexcept;
+
+        /**
+         * @brief - Assign an ordering score to each move in its
+         *          weight. The best move from the table comes
+         *          first, then captures ordered by most valuable
+         *          victim and least valuable attacker, then the
+         *          killer moves and finally the quiet moves by
+         *          their history.
+         * @param c - the color playing the moves.
+         * @param moves - the moves to score.
+         * @param hash - the entry from the transposition table for
+         *               this position or null if there's none.
+         * @param ply - the distance to the root of the search.
+         */
+        void
+        score(const Color& c,
+              MoveList& moves,
+              const HashEntry* hash,
+              unsigned ply) const noexcept;
+
+        /**
+         * @brief - Move the move with the highest score among the
+         *          ones not yet searched at the input index.
+         * @param moves - the list of moves.
+         * @param id - the index of the next move to search.
+         */
+        static
+        void
+        pick(MoveList& moves, unsigned id) noexcept;
+
+        /**
+         * @brief - Register a move which produced a beta cutoff.
+         *          Only quiet moves are registered as captures
+         *          are already searched first.
+         * @param c - the color playing the move.
+         * @param m - the move.
+         * @param ply - the distance to the root of the search.
+         * @param depth - the remaining depth of the search.
+         */
+        void
+        cutoff(const Color& c,
+               const Move& m,
+               unsigned ply,
+               unsigned depth) noexcept;
+
+        /**
+         * @brief - Whether the input move is one of the killer
+         *          moves of the ply.
+         * @param m - the move.
+         * @param ply - the distance to the root of the search.
+         * @return - `true` if the move is a killer move.
+         */
+        bool
+        killer(const Move& m, unsigned ply) const noexcept;
+
+        /**
+         * @brief - Returns the history score of the move.
+         * @param c - the color playing the move.
+         * @param m - the move.
+         * @return - the score of the move, `0` if it never led to
+         *           a cutoff recently.
+         */
+        int
+        history(const Color& c, const Move& m) const noexcept;
+
+      private:
+
+        /// @brief - A move stored as its linear starting and
+        /// ending cells.
+        struct Killer {
+          int start;
+          int end;
+        };
+
+        /// @brief - Convenience define for the history of a
+        /// color, indexed by starting and ending cells.
+        using History = std::array<std::array<int, 64u>, 64u>;
+
+        /**
+         * @brief - The two most recent quiet moves which produced
+         *          a cutoff at each ply.
+         */
+        std::array<std::array<Killer, 2u>, MAX_PLY> m_killers;
+
+        /**
+         * @brief - The score of quiet moves for each color based
+         *          on the cutoffs they produced.
+         */
+        std::array<History, 2u> m_history;
+    };
+
+  }
+}
+
+#endif    /* MOVE_ORDERING_HH */
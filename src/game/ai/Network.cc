@@ -0,0 +1,125 @@
+
+# include "Network.hh"
+# include <fstream>
+# include <cstring>
+# include "Kernels.hh"
+
+namespace {
+
+  inline
+  std::uint8_t
+  activate(std::int32_t sum) noexcept {
+    std::int32_t v = sum >> NETWORK_WEIGHT_SHIFT;
+    return static_cast<std::uint8_t>(v < 0 ? 0 : (v > 127 ? 127 : v));
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    Network::Network(const std::string& file):
+      utils::CoreObject("network"),
+
+      m_featureBiases(NETWORK_HALF_DIMENSIONS),
+      m_featureWeights(NETWORK_FEATURES * NETWORK_HALF_DIMENSIONS),
+      m_hidden1Biases(NETWORK_HIDDEN_DIMENSIONS),
+      m_hidden1Weights(NETWORK_HIDDEN_DIMENSIONS * 2u * NETWORK_HALF_DIMENSIONS),
+      m_hidden2Biases(NETWORK_HIDDEN_DIMENSIONS),
+      m_hidden2Weights(NETWORK_HIDDEN_DIMENSIONS * NETWORK_HIDDEN_DIMENSIONS),
+      m_outputBias(0),
+      m_outputWeights(NETWORK_HIDDEN_DIMENSIONS)
+    {
+      setService("ai");
+
+      load(file);
+    }
+
+    unsigned
+    Network::feature(const Color& perspective,
+                     unsigned king,
+                     const Piece& p,
+                     unsigned cell) noexcept
+    {
+      unsigned flip = (perspective == Color::White ? 0u : 56u);
+      unsigned piece = 2u * static_cast<unsigned>(p.type()) + (p.color() == perspective ? 0u : 1u);
+
+      return ((king ^ flip) * 10u + piece) * 64u + (cell ^ flip);
+    }
+
+    const std::int16_t*
+    Network::biases() const noexcept {
+      return m_featureBiases.data();
+    }
+
+    const std::int16_t*
+    Network::weights(unsigned feature) const noexcept {
+      return m_featureWeights.data() + feature * NETWORK_HALF_DIMENSIONS;
+    }
+
+    int
+    Network::propagate(const std::int16_t* us, const std::int16_t* them) const noexcept {
+      alignas(32) std::uint8_t input[2u * NETWORK_HALF_DIMENSIONS];
+      kernels::clippedReLU(us, input, NETWORK_HALF_DIMENSIONS);
+      kernels::clippedReLU(them, input + NETWORK_HALF_DIMENSIONS, NETWORK_HALF_DIMENSIONS);
+
+      alignas(32) std::uint8_t hidden1[NETWORK_HIDDEN_DIMENSIONS];
+      for (unsigned id = 0u ; id < NETWORK_HIDDEN_DIMENSIONS ; ++id) {
+        const std::int8_t* w = m_hidden1Weights.data() + id * 2u * NETWORK_HALF_DIMENSIONS;
+        hidden1[id] = activate(m_hidden1Biases[id] + kernels::dot(input, w, 2u * NETWORK_HALF_DIMENSIONS));
+      }
+
+      alignas(32) std::uint8_t hidden2[NETWORK_HIDDEN_DIMENSIONS];
+      for (unsigned id = 0u ; id < NETWORK_HIDDEN_DIMENSIONS ; ++id) {
+        const std::int8_t* w = m_hidden2Weights.data() + id * NETWORK_HIDDEN_DIMENSIONS;
+        hidden2[id] = activate(m_hidden2Biases[id] + kernels::dot(hidden1, w, NETWORK_HIDDEN_DIMENSIONS));
+      }
+
+      std::int32_t out = m_outputBias + kernels::dot(hidden2, m_outputWeights.data(), NETWORK_HIDDEN_DIMENSIONS);
+
+      return out / NETWORK_OUTPUT_SCALE;
+    }
+
+    void
+    Network::load(const std::string& file) {
+      std::ifstream in(file, std::ios::binary);
+      if (!in.good()) {
+        error("Failed to load network from \"" + file + "\"", "Unable to open file");
+      }
+
+      char magic[sizeof(NETWORK_MAGIC) - 1u];
+      in.read(magic, sizeof(magic));
+      if (!in.good() || std::memcmp(magic, NETWORK_MAGIC, sizeof(magic)) != 0) {
+        error("Failed to load network from \"" + file + "\"", "Invalid header");
+      }
+
+      // The values are read as is, which assumes a little
+      // endian machine.
+      auto read = [&in](void* data, std::size_t bytes) {
+        in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        return in.good();
+      };
+
+      bool valid =
+        read(m_featureBiases.data(), m_featureBiases.size() * sizeof(std::int16_t)) &&
+        read(m_featureWeights.data(), m_featureWeights.size() * sizeof(std::int16_t)) &&
+        read(m_hidden1Biases.data(), m_hidden1Biases.size() * sizeof(std::int32_t)) &&
+        read(m_hidden1Weights.data(), m_hidden1Weights.size()) &&
+        read(m_hidden2Biases.data(), m_hidden2Biases.size() * sizeof(std::int32_t)) &&
+        read(m_hidden2Weights.data(), m_hidden2Weights.size()) &&
+        read(&m_outputBias, sizeof(std::int32_t)) &&
+        read(m_outputWeights.data(), m_outputWeights.size());
+
+      if (!valid) {
+        error("Failed to load network from \"" + file + "\"", "File is too short");
+      }
+
+      if (in.peek() != std::ifstream::traits_type::eof()) {
+        error("Failed to load network from \"" + file + "\"", "File is too long");
+      }
+
+      info("Loaded network from \"" + file + "\" using " + kernels::instructions() + " kernels");
+    }
+
+  }
+}
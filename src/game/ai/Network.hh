@@ -0,0 +1,168 @@
+#ifndef    NETWORK_HH
+# define   NETWORK_HH
+
+# include <memory>
+# include <vector>
+# include <cstdint>
+# include <core_utils/CoreObject.hh>
+# include "Piece.hh"
+
+/// @brief - The number of neurons of the first layer for
+/// each perspective: the first layer concatenates the ones
+/// of the side to move and of its opponent.
+# define NETWORK_HALF_DIMENSIONS 256u
+
+/// @brief - The number of neurons of the two hidden layers.
+# define NETWORK_HIDDEN_DIMENSIONS 32u
+
+/// @brief - The number of input features of a perspective:
+/// one for each cell of its king, piece other than a king
+/// (five types in two colors) and cell of this piece.
+# define NETWORK_FEATURES (64u * 10u * 64u)
+
+/// @brief - The bytes at the start of a network file.
+# define NETWORK_MAGIC "CHESSNN1"
+
+/// @brief - The shift applied to the output of the hidden
+/// layers to bring them back to the range of activations.
+# define NETWORK_WEIGHT_SHIFT 6
+
+/// @brief - The output of the network is divided by this
+/// value to produce an evaluation in centipawns.
+# define NETWORK_OUTPUT_SCALE 16
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - An efficiently updatable neural network using
+    /// HalfKP input features: each active feature describes a
+    /// piece on a cell relatively to the king of a perspective.
+    /// The first layer is not computed by the network: its
+    /// output is accumulated by the evaluator as pieces move
+    /// and passed to `propagate` which computes the remaining
+    /// layers with quantized weights.
+    /// The weights are loaded from a file made of:
+    ///   - the magic `NETWORK_MAGIC`,
+    ///   - the int16 biases and weights of the first layer,
+    ///     the weights being grouped by feature,
+    ///   - the int32 biases and int8 weights of each of the
+    ///     two hidden layers, grouped by neuron,
+    ///   - the int32 bias and int8 weights of the output.
+    /// All values are stored in little endian.
+    class Network: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Load the network stored in the input file.
+         *          Raises an error if the file can't be read or
+         *          does not have the expected size.
+         * @param file - the path to the file.
+         */
+        Network(const std::string& file);
+
+        /**
+         * @brief - Returns the index of the feature of a piece on
+         *          a cell for the input perspective. The cells are
+         *          flipped vertically for black so that both sides
+         *          share the same weights.
+         * @param perspective - the color of the perspective.
+         * @param king - the linear index of the cell of the king
+         *               of the perspective.
+         * @param p - the piece, which should not be a king.
+         * @param cell - the linear index of the cell of the piece.
+         * @return - the index of the feature.
+         */
+        static
+        unsigned
+        feature(const Color& perspective,
+                unsigned king,
+                const Piece& p,
+                unsigned cell) noexcept;
+
+        /**
+         * @brief - Returns the biases of the first layer.
+         * @return - the `NETWORK_HALF_DIMENSIONS` biases.
+         */
+        const std::int16_t*
+        biases() const noexcept;
+
+        /**
+         * @brief - Returns the weights of a feature in the first
+         *          layer.
+         * @param feature - the index of the feature.
+         * @return - the `NETWORK_HALF_DIMENSIONS` weights.
+         */
+        const std::int16_t*
+        weights(unsigned feature) const noexcept;
+
+        /**
+         * @brief - Computes the output of the network from the
+         *          output of the first layer for both sides.
+         * @param us - the first layer for the side to move.
+         * @param them - the first layer for the opponent.
+         * @return - the evaluation in centipawns from the point
+         *           of view of the side to move.
+         */
+        int
+        propagate(const std::int16_t* us, const std::int16_t* them) const noexcept;
+
+      private:
+
+        /**
+         * @brief - Read the weights from the input file.
+         * @param file - the path to the file.
+         */
+        void
+        load(const std::string& file);
+
+      private:
+
+        /**
+         * @brief - The biases of the first layer.
+         */
+        std::vector<std::int16_t> m_featureBiases;
+
+        /**
+         * @brief - The weights of the first layer, grouped by
+         *          feature.
+         */
+        std::vector<std::int16_t> m_featureWeights;
+
+        /**
+         * @brief - The biases of the first hidden layer.
+         */
+        std::vector<std::int32_t> m_hidden1Biases;
+
+        /**
+         * @brief - The weights of the first hidden layer, grouped
+         *          by neuron.
+         */
+        std::vector<std::int8_t> m_hidden1Weights;
+
+        /**
+         * @brief - The biases of the second hidden layer.
+         */
+        std::vector<std::int32_t> m_hidden2Biases;
+
+        /**
+         * @brief - The weights of the second hidden layer.
+         */
+        std::vector<std::int8_t> m_hidden2Weights;
+
+        /**
+         * @brief - The bias of the output.
+         */
+        std::int32_t m_outputBias;
+
+        /**
+         * @brief - The weights of the output.
+         */
+        std::vector<std::int8_t> m_outputWeights;
+    };
+
+    using NetworkShPtr = std::shared_ptr<const Network>;
+
+  }
+}
+
+#endif    /* NETWORK_HH */
@@ -0,0 +1,132 @@
+
+# include "NetworkEvaluator.hh"
+# include "Kernels.hh"
+# include "MoveOrdering.hh"
+
+namespace {
+
+  unsigned
+  colorIndex(const chess::Color& c) noexcept {
+    return (c == chess::Color::White ? 0u : 1u);
+  }
+
+  unsigned
+  kingCell(const chess::Color& c, const chess::Board& b) noexcept {
+    chess::Bitboard king = b.bitboard(c, chess::Type::King);
+    return (king == 0u ? 0u : static_cast<unsigned>(chess::bitboard::first(king)));
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    NetworkEvaluator::NetworkEvaluator(NetworkShPtr network):
+      m_network(network),
+      // One accumulator for the root and one for each ply of
+      // the search.
+      m_stack(MAX_PLY + 1u),
+      m_current(0u)
+    {}
+
+    std::unique_ptr<Evaluator>
+    NetworkEvaluator::clone() const {
+      return std::make_unique<NetworkEvaluator>(m_network);
+    }
+
+    void
+    NetworkEvaluator::reset(const Board& b) noexcept {
+      m_current = 0u;
+
+      refresh(Color::White, b, m_stack[0u]);
+      refresh(Color::Black, b, m_stack[0u]);
+    }
+
+    void
+    NetworkEvaluator::push(const Board& b) noexcept {
+      const Accumulator& prev = m_stack[m_current];
+      ++m_current;
+      Accumulator& acc = m_stack[m_current];
+
+      acc = prev;
+
+      const PieceChanges& changes = b.changes();
+      Color perspectives[] = {Color::White, Color::Black};
+
+      for (unsigned p = 0u ; p < 2u ; ++p) {
+        const Color& perspective = perspectives[p];
+        std::int16_t* values = acc.values[colorIndex(perspective)].data();
+
+        // All the features depend on the cell of the king: in
+        // case it moved everything needs to be computed again.
+        bool moved = false;
+        for (unsigned id = 0u ; id < changes.size() && !moved ; ++id) {
+          moved = changes[id].piece.king() && changes[id].piece.color() == perspective;
+        }
+
+        if (moved) {
+          refresh(perspective, b, acc);
+          continue;
+        }
+
+        unsigned king = kingCell(perspective, b);
+
+        for (unsigned id = 0u ; id < changes.size() ; ++id) {
+          const PieceChange& c = changes[id];
+          if (c.piece.king()) {
+            continue;
+          }
+
+          const std::int16_t* w = m_network->weights(Network::feature(perspective, king, c.piece, c.cell));
+          if (c.added) {
+            kernels::add(values, w, NETWORK_HALF_DIMENSIONS);
+          }
+          else {
+            kernels::sub(values, w, NETWORK_HALF_DIMENSIONS);
+          }
+        }
+      }
+    }
+
+    void
+    NetworkEvaluator::pop() noexcept {
+      if (m_current > 0u) {
+        --m_current;
+      }
+    }
+
+    int
+    NetworkEvaluator::evaluate(const Color& c, const Board& /*b*/) noexcept {
+      const Accumulator& acc = m_stack[m_current];
+
+      return m_network->propagate(
+        acc.values[colorIndex(c)].data(),
+        acc.values[colorIndex(oppositeColor(c))].data()
+      );
+    }
+
+    void
+    NetworkEvaluator::refresh(const Color& perspective,
+                              const Board& b,
+                              Accumulator& acc) const noexcept
+    {
+      std::int16_t* values = acc.values[colorIndex(perspective)].data();
+      const std::int16_t* biases = m_network->biases();
+
+      for (unsigned id = 0u ; id < NETWORK_HALF_DIMENSIONS ; ++id) {
+        values[id] = biases[id];
+      }
+
+      unsigned king = kingCell(perspective, b);
+
+      Bitboard pieces = b.occupancy() & ~b.bitboard(Color::White, Type::King) & ~b.bitboard(Color::Black, Type::King);
+      while (pieces != 0u) {
+        unsigned cell = static_cast<unsigned>(bitboard::pop(pieces));
+        const Piece& p = b.at(cell % 8u, cell / 8u);
+
+        kernels::add(values, m_network->weights(Network::feature(perspective, king, p, cell)), NETWORK_HALF_DIMENSIONS);
+      }
+    }
+
+  }
+}
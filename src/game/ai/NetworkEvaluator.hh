@@ -0,0 +1,86 @@
+#ifndef    NETWORK_EVALUATOR_HH
+# define   NETWORK_EVALUATOR_HH
+
+# include <array>
+# include <vector>
+# include "Evaluator.hh"
+# include "Network.hh"
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - Evaluates positions with a neural network. The
+    /// output of the first layer is kept for each position on
+    /// the path from the root of the search: it is updated from
+    /// the pieces which moved, except for the perspective whose
+    /// king moved which is computed again from all the pieces.
+    class NetworkEvaluator: public Evaluator {
+      public:
+
+        /**
+         * @brief - Create an evaluator using the input network.
+         * @param network - the network, shared by all the copies
+         *                  of the evaluator.
+         */
+        NetworkEvaluator(NetworkShPtr network);
+
+        std::unique_ptr<Evaluator>
+        clone() const override;
+
+        void
+        reset(const Board& b) noexcept override;
+
+        void
+        push(const Board& b) noexcept override;
+
+        void
+        pop() noexcept override;
+
+        int
+        evaluate(const Color& c, const Board& b) noexcept override;
+
+      private:
+
+        /// @brief - The output of the first layer for a position,
+        /// for both perspectives.
+        struct Accumulator {
+          // The values indexed by the color of the perspective.
+          alignas(32) std::array<std::array<std::int16_t, NETWORK_HALF_DIMENSIONS>, 2u> values;
+        };
+
+        /**
+         * @brief - Computes the output of the first layer for the
+         *          input perspective from all the pieces.
+         * @param perspective - the color of the perspective.
+         * @param b - the board.
+         * @param acc - the accumulator to update.
+         */
+        void
+        refresh(const Color& perspective,
+                const Board& b,
+                Accumulator& acc) const noexcept;
+
+      private:
+
+        /**
+         * @brief - The network used to evaluate positions.
+         */
+        NetworkShPtr m_network;
+
+        /**
+         * @brief - The accumulators of the positions from the root
+         *          of the search to the current one.
+         */
+        std::vector<Accumulator> m_stack;
+
+        /**
+         * @brief - The index of the accumulator of the current
+         *          position.
+         */
+        unsigned m_current;
+    };
+
+  }
+}
+
+#endif    /* NETWORK_EVALUATOR_HH */
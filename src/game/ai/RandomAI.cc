@@ -9,10 +9,10 @@ namespace chess {
     AI(color, "random")
   {}
 
-  std::vector<ai::Move>
+  ai::MoveList
   RandomAI::generateMoves(const Board& b) noexcept {
     // Generate moves.
-    std::vector<ai::Move> moves = ai::generate(m_color, b);
+    ai::MoveList moves = ai::generate(m_color, b);
 
     // Randomly classify moves.
     std::random_device rd;
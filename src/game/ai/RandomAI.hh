@@ -25,7 +25,7 @@ namespace chess {
        * @return -  the sorted list of moves from the most favourable
        *            one to the least favourable one.
        */
-      std::vector<ai::Move>
+      ai::MoveList
       generateMoves(const Board& b) noexcept override;
   };
 
@@ -0,0 +1,1041 @@
+
+# include "Searcher.hh"
+# include <algorithm>
+# include "MoveGeneration.hh"
+
+/// @brief - Scores above this threshold (in absolute value)
+/// are considered to be mate scores. They are stored in the
+/// transposition table relatively to the position and not
+/// to the root of the search.
+# define MATE_THRESHOLD (CHECKMATE_EVALUATION - 256)
+
+/// @brief - The number of nodes visited between two checks
+/// of the time spent in the search. Must be a power of two.
+# define TIME_CHECK_INTERVAL 1024u
+
+/// @brief - The margin added to the value of a captured piece
+/// to decide whether the capture can possibly raise alpha in
+/// the quiescence search.
+# define DELTA_MARGIN 200
+
+/// @brief - The minimum remaining depth to try a null move.
+# define NULL_MOVE_MIN_DEPTH 3u
+
+/// @brief - The depth reduction applied to the search after
+/// a null move. It is increased by one for deep searches.
+# define NULL_MOVE_REDUCTION 2u
+
+/// @brief - The number of pieces (pawns and king excluded)
+/// below which the result of a null move is verified by a
+/// reduced search, as zugzwang positions become likely.
+# define NULL_MOVE_VERIFICATION_PIECES 2
+
+/// @brief - The number of moves searched at full depth before
+/// reducing the depth of the next quiet moves.
+# define LMR_FULL_MOVES 3u
+
+/// @brief - The index after which moves are reduced by one
+/// more ply.
+# define LMR_LATE_MOVES 8u
+
+/// @brief - The minimum remaining depth to reduce moves.
+# define LMR_MIN_DEPTH 3u
+
+/// @brief - The maximum remaining depth at which quiet moves
+/// can be skipped by futility pruning.
+# define FUTILITY_DEPTH 2u
+
+/// @brief - The margin per remaining ply used to determine
+/// whether quiet moves can raise alpha.
+# define FUTILITY_MARGIN 250
+
+/// @brief - The margin below alpha under which the search
+/// falls back to the quiescence search one ply before the
+/// leaves.
+# define RAZORING_MARGIN 400
+
+/// @brief - The minimum depth at which the search starts with
+/// a window around the score of the previous iteration.
+# define ASPIRATION_MIN_DEPTH 3u
+
+/// @brief - The initial half width of the aspiration window.
+/// It is doubled each time the search falls out of it.
+# define ASPIRATION_WINDOW 150
+
+/// @brief - The half width of the aspiration window above
+/// which the search uses the full window.
+# define ASPIRATION_MAX_WINDOW 5000
+
+/// @brief - Activate these logs to debug the AI.
+// # define PRE_ROOT_LOG
+// # define ROOT_LOG
+// # define EVALUATE_LOG
+// # define EXPLORE_LOG
+// # define SUMMARY_LOG
+
+namespace {
+
+  /**
+   * @brief - Returns the number of pieces which are neither
+   *          pawns nor the king for the input color.
+   * @param c - the color.
+   * @param b - the board.
+   * @return - the number of pieces.
+   */
+  int
+  pieces(const chess::Color& c,
+         const chess::Board& b) noexcept
+  {
+    return
+      chess::bitboard::count(b.bitboard(c, chess::Type::Knight)) +
+      chess::bitboard::count(b.bitboard(c, chess::Type::Bishop)) +
+      chess::bitboard::count(b.bitboard(c, chess::Type::Rook)) +
+      chess::bitboard::count(b.bitboard(c, chess::Type::Queen));
+  }
+
+  unsigned
+  index(const chess::Coordinates& c) noexcept {
+    return static_cast<unsigned>(c.y() * 8 + c.x());
+  }
+
+  int
+  toTable(int score, unsigned ply) noexcept {
+    if (score >= MATE_THRESHOLD) {
+      return score + static_cast<int>(ply);
+    }
+    if (score <= -MATE_THRESHOLD) {
+      return score - static_cast<int>(ply);
+    }
+
+    return score;
+  }
+
+  int
+  fromTable(int score, unsigned ply) noexcept {
+    if (score >= MATE_THRESHOLD) {
+      return score - static_cast<int>(ply);
+    }
+    if (score <= -MATE_THRESHOLD) {
+      return score + static_cast<int>(ply);
+    }
+
+    return score;
+  }
+
+  std::string
+  moveToString(const chess::ai::Move& m) noexcept {
+    std::string out;
+
+    out += chess::cells::toString(static_cast<chess::cells::Value>(index(m.start)));
+    out += chess::cells::toString(static_cast<chess::cells::Value>(index(m.end)));
+
+    if (m.promotion != chess::Type::None) {
+      out += chess::Piece::generate(m.promotion, chess::Color::Black).algebraic();
+    }
+
+    return out;
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    Searcher::Searcher(unsigned id,
+                       TranspositionTable& table,
+                       const SearchLimits& limits,
+                       const Pruning& pruning,
+                       const std::atomic<bool>& abort,
+                       const std::atomic<bool>& ponder,
+                       std::unique_ptr<Evaluator> evaluator,
+                       TablebaseShPtr tablebase):
+      utils::CoreObject("searcher_" + std::to_string(id)),
+
+      m_id(id),
+      m_table(table),
+      m_limits(limits),
+      m_pruning(pruning),
+      m_abort(abort),
+      m_ponder(ponder),
+      m_evaluator(std::move(evaluator)),
+      m_tablebase(tablebase),
+      m_color(Color::White),
+      m_depth(0u),
+      m_start(),
+      m_nodes(0u),
+      m_pruned(0u),
+      m_quiescence(0u),
+      m_cutoffs(0u),
+      m_firstMoveCutoffs(0u),
+      m_iterations(),
+      m_stopped(false),
+      m_stats({0u, 0u, 0u, 0u}),
+      m_ordering(),
+      m_pv(),
+      m_pvLength(),
+      m_line(),
+      m_undo(),
+      m_undoCount(0u),
+      m_trace()
+    {
+      setService("ai");
+
+      m_pvLength.fill(0u);
+    }
+
+    unsigned
+    Searcher::run(const Color& c,
+                  const Board& b,
+                  MoveList& moves,
+                  const utils::TimeStamp& start,
+                  unsigned first) noexcept
+    {
+      m_color = c;
+      m_start = start;
+      m_nodes = 0u;
+      m_pruned = 0u;
+      m_quiescence = 0u;
+      m_cutoffs = 0u;
+      m_firstMoveCutoffs = 0u;
+      m_iterations.clear();
+      m_stopped = false;
+      m_stats = {0u, 0u, 0u, 0u};
+
+      m_ordering.newSearch();
+      m_line.clear();
+
+      // Only keep the events of this search.
+      m_trace.reset(m_trace.enabled());
+
+      // Start with the best move of a previous search if any
+      // and then the most promising moves. The following
+      // iterations use the order of the previous one.
+      HashEntry entry;
+      bool hit = m_table.probe(b.key(), entry, m_stats);
+
+      m_ordering.score(m_color, moves, (hit ? &entry : nullptr), 0u);
+      std::stable_sort(
+        moves.begin(),
+        moves.end(),
+        [](const Move& lhs, const Move& rhs) {
+          return lhs.weight > rhs.weight;
+        }
+      );
+
+      // Deepen the search one ply at a time: each iteration is
+      // cheap compared to the next one and fills the table with
+      // the best moves which are used to order the moves of the
+      // next iteration.
+      MoveList best = moves;
+      unsigned completed = 0u;
+      int score = 0;
+
+      unsigned maxDepth = std::min(m_limits.depth, MAX_PLY - 1u);
+
+      for (unsigned depth = std::max(first, 1u) ; depth <= maxDepth && !moves.empty() ; ++depth) {
+        m_depth = depth;
+
+        std::uint64_t visited = m_nodes;
+        utils::TimeStamp begin = utils::now();
+
+        // Search in a narrow window around the score of the
+        // previous iteration, as it is usually close and the
+        // narrow window produces more cutoffs. The window is
+        // widened in the direction of the failure if the score
+        // falls out of it.
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -CHECKMATE_EVALUATION;
+        int beta = CHECKMATE_EVALUATION;
+
+        if (completed > 0u && depth >= ASPIRATION_MIN_DEPTH && score > -MATE_THRESHOLD && score < MATE_THRESHOLD) {
+          alpha = score - delta;
+          beta = score + delta;
+        }
+
+        MoveList current = best;
+        int w = 0;
+
+        while (!m_stopped) {
+          w = search(b, current, alpha, beta);
+
+          if (w > alpha && w < beta) {
+            break;
+          }
+
+          delta *= 2;
+
+          if (delta > ASPIRATION_MAX_WINDOW) {
+            alpha = -CHECKMATE_EVALUATION;
+            beta = CHECKMATE_EVALUATION;
+          }
+          else if (w <= alpha) {
+            alpha = std::max(w - delta, -CHECKMATE_EVALUATION);
+          }
+          else {
+            beta = std::min(w + delta, CHECKMATE_EVALUATION);
+          }
+
+          if (m_id == 0u) {
+            debug(
+              "Depth " + std::to_string(depth) + ": score " + std::to_string(w) + " out of window, " +
+              "searching again in [" + std::to_string(alpha) + ", " + std::to_string(beta) + "]"
+            );
+          }
+        }
+
+        // Only keep the results of complete iterations.
+        if (m_stopped) {
+          break;
+        }
+
+        best = current;
+        completed = depth;
+        score = w;
+
+        // The iteration visits the same nodes as the previous
+        // one, and one more ply: comparing both measures how
+        // much the search is pruned.
+        IterationStats is{depth, m_nodes - visited, utils::diffInMs(begin, utils::now()), 0.0f};
+        if (!m_iterations.empty() && m_iterations.back().nodes > 0u) {
+          is.branching = 1.0f * is.nodes / m_iterations.back().nodes;
+        }
+
+        m_iterations.push_back(is);
+
+        m_line.clear();
+        std::string line;
+        for (unsigned id = 0u ; id < m_pvLength[0] ; ++id) {
+          m_line.push_back(m_pv[0][id]);
+          line += (id > 0u ? " " : "") + moveToString(m_pv[0][id]);
+        }
+
+        if (m_id == 0u) {
+          debug(
+            "Depth " + std::to_string(depth) + ": best move from " + best[0].start.toString() +
+            " to " + best[0].end.toString() + " with weight " + std::to_string(best[0].weight) +
+            " (nodes: " + std::to_string(m_nodes) + ", pv: " + line + ")"
+          );
+        }
+
+        // No need to search deeper when a mate is found.
+        if (best[0].weight >= MATE_THRESHOLD || best[0].weight <= -MATE_THRESHOLD) {
+          break;
+        }
+
+        // The next iteration will most likely take longer than
+        // all the previous ones: don't start it if more than
+        // half of the time budget is already used.
+        if (m_limits.time > 0u &&
+            !m_ponder.load(std::memory_order_relaxed) &&
+            2.0f * utils::diffInMs(m_start, utils::now()) > m_limits.time)
+        {
+          break;
+        }
+      }
+
+      moves = best;
+
+      return completed;
+    }
+
+    const MoveList&
+    Searcher::principalVariation() const noexcept {
+      return m_line;
+    }
+
+    std::uint64_t
+    Searcher::nodes() const noexcept {
+      return m_nodes;
+    }
+
+    std::uint64_t
+    Searcher::pruned() const noexcept {
+      return m_pruned;
+    }
+
+    const TableStats&
+    Searcher::stats() const noexcept {
+      return m_stats;
+    }
+
+    std::uint64_t
+    Searcher::quiescenceNodes() const noexcept {
+      return m_quiescence;
+    }
+
+    std::uint64_t
+    Searcher::cutoffs() const noexcept {
+      return m_cutoffs;
+    }
+
+    std::uint64_t
+    Searcher::firstMoveCutoffs() const noexcept {
+      return m_firstMoveCutoffs;
+    }
+
+    const std::vector<IterationStats>&
+    Searcher::iterations() const noexcept {
+      return m_iterations;
+    }
+
+    void
+    Searcher::setTracing(bool enabled) {
+      m_trace.reset(enabled);
+    }
+
+    const TraceBuffer&
+    Searcher::trace() const noexcept {
+      return m_trace;
+    }
+
+    int
+    Searcher::search(const Board& b,
+                     MoveList& moves,
+                     int alpha,
+                     int beta) noexcept
+    {
+      int originalAlpha = alpha;
+      int bestWeight = -CHECKMATE_EVALUATION;
+      unsigned best = 0u;
+
+      m_pvLength[0] = 0u;
+      m_trace.enter(0u, m_depth, b.key(), alpha, beta);
+
+      // The whole search is performed on a single copy of
+      // the board: moves are made and unmade in place.
+      Board cb(b);
+      m_evaluator->reset(cb);
+      m_undoCount = 0u;
+
+      for (unsigned id = 0u ; id < moves.size() ; ++id) {
+        m_trace.move(0u, m_depth, id, moves[id], alpha, beta);
+
+        // Apply the move, including the promotion if any.
+        make(cb, moves[id]);
+
+# ifdef PRE_ROOT_LOG
+        std::string msg = "Evaluating ";
+        msg += cb.at(moves[id].end).fullName();
+        msg += " from ";
+        msg += moves[id].start.toString();
+        msg += " to ";
+        msg += moves[id].end.toString();
+
+        notice("[0] " + colorToString(m_color) + " " + msg);
+# endif
+
+        // The idea of the alpha-beta pruning is described
+        // in the following link:
+        // https://en.wikipedia.org/wiki/Alpha%E2%80%93beta_pruning#Pseudocode
+        // The first move is expected to be the best one: the
+        // other ones are searched with a null window to prove
+        // that they are worse, and searched again if not.
+# ifdef ROOT_LOG
+        std::uint64_t visited = m_nodes;
+# endif
+        Color o = oppositeColor(m_color);
+        if (id == 0u) {
+          moves[id].weight = -evaluate(o, cb, -beta, -alpha, 1u, m_depth - 1u, true);
+        }
+        else {
+          moves[id].weight = -evaluate(o, cb, -alpha - 1, -alpha, 1u, m_depth - 1u, true);
+
+          if (moves[id].weight > alpha && moves[id].weight < beta && !m_stopped) {
+            moves[id].weight = -evaluate(o, cb, -beta, -alpha, 1u, m_depth - 1u, true);
+          }
+        }
+
+# ifdef ROOT_LOG
+#  ifdef PRE_ROOT_LOG
+        msg = "Evaluated ";
+#  else
+        std::string msg = "Evaluated ";
+#  endif
+        msg += cb.at(moves[id].end).fullName();
+        msg += " from ";
+        msg += moves[id].start.toString();
+        msg += " to ";
+        msg += moves[id].end.toString();
+        msg += " to ";
+        msg += std::to_string(moves[id].weight);
+        msg += " (nodes: ";
+        msg += std::to_string(m_nodes - visited);
+        msg += ", pruned: ";
+        msg += std::to_string(m_pruned);
+        msg += ")";
+
+        notice("[0] " + colorToString(m_color) + " " + msg);
+# endif
+        unmake(cb);
+
+        if (m_stopped) {
+          m_trace.leave(0u, m_depth, 0);
+          return 0;
+        }
+
+        if (moves[id].weight > bestWeight) {
+          bestWeight = moves[id].weight;
+          best = id;
+        }
+
+        // Handle alpha-beta pruning. Only the moves improving
+        // alpha have an exact score: the others are an upper
+        // bound of their actual value.
+        if (moves[id].weight > alpha) {
+          alpha = moves[id].weight;
+          updatePV(0u, moves[id]);
+        }
+        if (alpha >= beta) {
+          m_trace.cutoff(0u, m_depth, id, moves[id], moves[id].weight);
+          break;
+        }
+      }
+
+      // Keep the best move first so that it is picked even if
+      // another move has a bound equal to its score. The other
+      // moves keep their relative order.
+      if (moves.empty()) {
+        m_trace.leave(0u, m_depth, 0);
+        return 0;
+      }
+
+      std::rotate(moves.begin(), moves.begin() + best, moves.begin() + best + 1u);
+
+      Bound bound = Bound::Exact;
+      if (bestWeight <= originalAlpha) {
+        bound = Bound::Upper;
+      }
+      else if (bestWeight >= beta) {
+        bound = Bound::Lower;
+      }
+
+      m_table.store(
+        m_stats,
+        b.key(),
+        HashEntry{
+          m_depth,
+          bound,
+          toTable(bestWeight, 0u),
+          index(moves[0].start),
+          index(moves[0].end),
+          moves[0].promotion
+        }
+      );
+
+      m_trace.leave(0u, m_depth, bestWeight);
+
+      return bestWeight;
+    }
+
+    void
+    Searcher::updatePV(unsigned ply, const Move& m) noexcept {
+      if (ply + 1u >= MAX_PLY) {
+        return;
+      }
+
+      // The line of this ply is the move followed by the line
+      // of the next ply.
+      m_pv[ply][ply] = m;
+
+      unsigned length = std::max(m_pvLength[ply + 1u], ply + 1u);
+      for (unsigned id = ply + 1u ; id < length ; ++id) {
+        m_pv[ply][id] = m_pv[ply + 1u][id];
+      }
+
+      m_pvLength[ply] = length;
+    }
+
+    inline
+    void
+    Searcher::make(Board& b, const Move& m) noexcept {
+      b.makeMove(m.start, m.end, m.promotion, m_undo[m_undoCount]);
+      ++m_undoCount;
+      m_evaluator->push(b);
+    }
+
+    inline
+    void
+    Searcher::unmake(Board& b) noexcept {
+      --m_undoCount;
+      b.unmakeMove(m_undo[m_undoCount]);
+      m_evaluator->pop();
+    }
+
+    bool
+    Searcher::stop() noexcept {
+      if (m_stopped) {
+        return true;
+      }
+
+      // The main searcher is the one setting the flag so it
+      // is never aborted during its first iteration.
+      if (m_abort.load(std::memory_order_relaxed)) {
+        m_stopped = true;
+        return true;
+      }
+
+      // While pondering the budget is not used: the search
+      // goes on until the opponent plays.
+      if (m_ponder.load(std::memory_order_relaxed)) {
+        return false;
+      }
+
+      if (m_id == 0u && m_depth <= 1u) {
+        return false;
+      }
+
+      if (m_limits.nodes > 0u && m_nodes >= m_limits.nodes) {
+        m_stopped = true;
+      }
+
+      // Fetching the time is not free: only do it from time
+      // to time.
+      if (m_limits.time > 0u && (m_nodes & (TIME_CHECK_INTERVAL - 1u)) == 0u) {
+        m_stopped = m_stopped || (utils::now() > m_start + utils::toMilliseconds(m_limits.time));
+      }
+
+      return m_stopped;
+    }
+
+    inline
+    int
+    Searcher::evaluate(const Color& c,
+                       Board& b,
+                       int alpha,
+                       int beta,
+                       unsigned depth,
+                       unsigned remaining,
+                       bool null) noexcept
+    {
+      m_trace.enter(depth, remaining, b.key(), alpha, beta);
+      int w = evaluateNode(c, b, alpha, beta, depth, remaining, null);
+      m_trace.leave(depth, remaining, w);
+
+      return w;
+    }
+
+    int
+    Searcher::evaluateNode(const Color& c,
+                           Board& b,
+                           int alpha,
+                           int beta,
+                           unsigned depth,
+                           unsigned remaining,
+                           bool null) noexcept
+    {
+# if defined(EVALUATE_LOG) || defined(EXPLORE_LOG) || defined(SUMMARY_LOG)
+      auto indent = [](unsigned depth) {
+        return std::string(2u * depth, ' ');
+      };
+
+      auto print = [this, &depth, &indent, &c](const std::string msg) {
+        notice(
+          "[" + std::to_string(depth) + "] " + indent(depth) +
+          colorToString(c) + " " + msg
+        );
+      };
+# endif
+
+      // The principal variation starts empty at each node.
+      if (depth < MAX_PLY) {
+        m_pvLength[depth] = depth;
+      }
+
+      // Positions with few pieces are solved: the distance to
+      // mate is used as the score of the position.
+      TablebaseResult result;
+      if (m_tablebase != nullptr && m_tablebase->probe(b, c, result)) {
+# ifdef EVALUATE_LOG
+        print("tablebase: " + std::to_string(Tablebase::score(result, depth)));
+# endif
+        return Tablebase::score(result, depth);
+      }
+
+      // Color represents the player to move in this state
+      // of the board: the score is computed from its point
+      // of view and negated by the caller.
+      if (remaining == 0u) {
+        // We reached the end of the main search, make sure
+        // the board is evaluated in a quiet position.
+        int w = quiescenceNode(c, b, alpha, beta, depth);
+# ifdef EVALUATE_LOG
+        print("board: " + std::to_string(w));
+# endif
+
+        return w;
+      }
+
+      ++m_nodes;
+
+      // The value is not used by the caller when the search
+      // is stopped.
+      if (stop()) {
+        return 0;
+      }
+
+      // Check whether this position was already searched at
+      // least as deep as what we would do here.
+      int originalAlpha = alpha;
+
+      HashEntry entry;
+      bool hit = m_table.probe(b.key(), entry, m_stats);
+
+      if (hit && entry.depth >= remaining) {
+        int w = fromTable(entry.score, depth);
+
+        if (entry.bound == Bound::Exact ||
+            (entry.bound == Bound::Lower && w >= beta) ||
+            (entry.bound == Bound::Upper && w <= alpha))
+        {
+# ifdef EVALUATE_LOG
+          print("table: " + std::to_string(w));
+# endif
+          return w;
+        }
+      }
+
+      // The selective techniques are not used when in check
+      // as the static evaluation is meaningless.
+      bool check = b.computeCheck(c);
+      int eval = (check ? -CHECKMATE_EVALUATION : m_evaluator->evaluate(c, b));
+
+      // One ply before the leaves, a position far below alpha
+      // is not likely to recover with a quiet move.
+      if (m_pruning.razoring && !check && remaining == 1u && eval + RAZORING_MARGIN <= alpha) {
+        return quiescenceNode(c, b, alpha, beta, depth);
+      }
+
+      // Let the opponent play twice: if the position is still
+      // above beta, a real move would most likely be as well.
+      // This fails in zugzwang, which happens mostly when only
+      // pawns are left: the null move is then not tried, or
+      // verified when few pieces are left.
+      int count = (check ? 0 : pieces(c, b));
+
+      if (m_pruning.nullMove && null && !check && remaining >= NULL_MOVE_MIN_DEPTH && eval >= beta && count > 0) {
+        unsigned r = NULL_MOVE_REDUCTION + (remaining > 6u ? 1u : 0u);
+        unsigned reduced = (remaining > r + 1u ? remaining - r - 1u : 0u);
+
+        UndoRecord undo;
+        b.makeNullMove(undo);
+        m_evaluator->push(b);
+        int w = -evaluate(oppositeColor(c), b, -beta, -beta + 1, depth + 1u, reduced, false);
+        b.unmakeNullMove(undo);
+        m_evaluator->pop();
+
+        if (m_stopped) {
+          return 0;
+        }
+
+        if (w >= beta) {
+          // Mates can't be proven with a null move.
+          if (w >= MATE_THRESHOLD) {
+            w = beta;
+          }
+
+          if (count > NULL_MOVE_VERIFICATION_PIECES) {
+            return w;
+          }
+
+          int v = evaluate(c, b, beta - 1, beta, depth, (remaining > r ? remaining - r : 0u), false);
+          if (m_stopped) {
+            return 0;
+          }
+          if (v >= beta) {
+            return w;
+          }
+        }
+      }
+
+      // Generate moves for the current color.
+      MoveList moves = generate(c, b);
+
+      // In case we don't have any legal moves, it means
+      // that we're either in stalemate or we can't get
+      // out of check.
+      if (moves.empty()) {
+        // Checkmate is valued with a very high value while
+        // stalemate is a draw. Note that to favour the moves
+        // that lead to a checkmate faster, we include the
+        // depth of the evaluation in the weight.
+        if (check) {
+          return -(CHECKMATE_EVALUATION - static_cast<int>(depth));
+        }
+
+        return 0;
+      }
+
+      // Close to the leaves, quiet moves are not likely to
+      // bring a position far below alpha back in the window.
+      bool futile =
+        m_pruning.futility &&
+        !check &&
+        remaining <= FUTILITY_DEPTH &&
+        alpha > -MATE_THRESHOLD &&
+        eval + FUTILITY_MARGIN * static_cast<int>(remaining) <= alpha;
+
+      // Explore the most promising moves first as they are
+      // likely to produce a cutoff.
+      m_ordering.score(c, moves, (hit ? &entry : nullptr), depth);
+
+      int bestWeight = -CHECKMATE_EVALUATION;
+      unsigned best = 0u;
+
+      // For each available position, evaluate the
+      // state of the board after making the move.
+      for (unsigned id = 0u ; id < moves.size() ; ++id) {
+        MoveOrdering::pick(moves, id);
+
+        bool quiet = moves[id].captured.invalid() && moves[id].promotion == Type::None;
+        bool late = !m_ordering.killer(moves[id], depth) && m_ordering.history(c, moves[id]) == 0;
+
+        // Apply the move, including the promotion if any.
+        make(b, moves[id]);
+        bool checking = b.computeCheck(oppositeColor(c));
+
+        if (futile && quiet && !checking && id > 0u) {
+          unmake(b);
+          ++m_pruned;
+          continue;
+        }
+
+        m_trace.move(depth, remaining, id, moves[id], alpha, beta);
+
+# ifdef EXPLORE_LOG
+        std::string msg = "Evaluating ";
+        msg += b.at(moves[id].end).fullName();
+        msg += " from ";
+        msg += moves[id].start.toString();
+        msg += " to ";
+        msg += moves[id].end.toString();
+        print(msg);
+
+        std::uint64_t visited = m_nodes;
+# endif
+
+        // Moves ordered last are less likely to be good: they
+        // are first searched with a reduced depth and only
+        // searched fully if they turn out to raise alpha.
+        unsigned r = 0u;
+        if (m_pruning.lateMoveReductions && quiet && !check && !checking &&
+            remaining >= LMR_MIN_DEPTH && id >= LMR_FULL_MOVES &&
+            !m_ordering.killer(moves[id], depth))
+        {
+          r = 1u;
+          if (id >= LMR_LATE_MOVES) {
+            ++r;
+          }
+          if (late) {
+            ++r;
+          }
+
+          r = std::min(r, remaining - 2u);
+        }
+
+        // The returned value represents the evaluation of the
+        // board and the best moves for the opponent. To obtain
+        // the valuation for us, we need to negate it.
+        // Only the first move is searched with the full window:
+        // the others are searched with a null window to prove
+        // that they are not better, and searched again if they
+        // are. Reduced moves are first searched again without
+        // the reduction.
+        Color o = oppositeColor(c);
+
+        if (id == 0u) {
+          moves[id].weight = -evaluate(o, b, -beta, -alpha, depth + 1u, remaining - 1u, true);
+        }
+        else {
+          moves[id].weight = -evaluate(o, b, -alpha - 1, -alpha, depth + 1u, remaining - 1u - r, true);
+
+          if (r > 0u && moves[id].weight > alpha && !m_stopped) {
+            moves[id].weight = -evaluate(o, b, -alpha - 1, -alpha, depth + 1u, remaining - 1u, true);
+          }
+          if (moves[id].weight > alpha && moves[id].weight < beta && !m_stopped) {
+            moves[id].weight = -evaluate(o, b, -beta, -alpha, depth + 1u, remaining - 1u, true);
+          }
+        }
+
+# ifdef EXPLORE_LOG
+        msg = "Evaluated ";
+        msg += b.at(moves[id].end).fullName();
+        msg += " from ";
+        msg += moves[id].start.toString();
+        msg += " to ";
+        msg += moves[id].end.toString();
+        msg += " to ";
+        msg += std::to_string(moves[id].weight);
+        msg += " (nodes: ";
+        msg += std::to_string(m_nodes - visited);
+        msg += ")";
+        print(msg);
+# endif
+
+        unmake(b);
+
+        // The scores of an interrupted search are meaningless.
+        if (m_stopped) {
+          return 0;
+        }
+
+        if (moves[id].weight > bestWeight) {
+          bestWeight = moves[id].weight;
+          best = id;
+        }
+
+        // Handle alpha-beta pruning.
+        if (moves[id].weight > alpha) {
+          alpha = moves[id].weight;
+          updatePV(depth, moves[id]);
+        }
+        if (alpha >= beta) {
+          m_trace.cutoff(depth, remaining, id, moves[id], moves[id].weight);
+          m_ordering.cutoff(c, moves[id], depth, remaining);
+          m_pruned += moves.size() - id;
+
+          ++m_cutoffs;
+          if (id == 0u) {
+            ++m_firstMoveCutoffs;
+          }
+
+          break;
+        }
+      }
+
+      // Register the result: the score is only exact if it is
+      // strictly within the initial window.
+      Bound bound = Bound::Exact;
+      if (bestWeight <= originalAlpha) {
+        bound = Bound::Upper;
+      }
+      else if (bestWeight >= beta) {
+        bound = Bound::Lower;
+      }
+
+      m_table.store(
+        m_stats,
+        b.key(),
+        HashEntry{
+          remaining,
+          bound,
+          toTable(bestWeight, depth),
+          index(moves[best].start),
+          index(moves[best].end),
+          moves[best].promotion
+        }
+      );
+
+# ifdef SUMMARY_LOG
+      std::string msg = "Analyzed ";
+      msg += std::to_string(moves.size());
+      msg += " move(s)";
+      msg += ", best: ";
+      msg += std::to_string(bestWeight);
+      msg += " (nodes: ";
+      msg += std::to_string(m_nodes);
+      msg += ")";
+      print(msg);
+# endif
+
+      return bestWeight;
+    }
+
+    inline
+    int
+    Searcher::quiescence(const Color& c,
+                         Board& b,
+                         int alpha,
+                         int beta,
+                         unsigned depth) noexcept
+    {
+      m_trace.enter(depth, 0u, b.key(), alpha, beta);
+      int w = quiescenceNode(c, b, alpha, beta, depth);
+      m_trace.leave(depth, 0u, w);
+
+      return w;
+    }
+
+    int
+    Searcher::quiescenceNode(const Color& c,
+                             Board& b,
+                             int alpha,
+                             int beta,
+                             unsigned depth) noexcept
+    {
+      if (depth < MAX_PLY) {
+        m_pvLength[depth] = depth;
+      }
+
+      ++m_nodes;
+      ++m_quiescence;
+
+      if (stop()) {
+        return 0;
+      }
+
+      // When in check all the evasions are searched and the
+      // side to move can't decide to keep the position.
+      bool check = b.computeCheck(c);
+      int standPat = -CHECKMATE_EVALUATION;
+
+      if (!check || depth >= MAX_PLY) {
+        standPat = m_evaluator->evaluate(c, b);
+
+        if (standPat >= beta || depth >= MAX_PLY) {
+          return standPat;
+        }
+
+        alpha = std::max(alpha, standPat);
+      }
+
+      MoveList moves = generate(c, b, true);
+
+      if (check && moves.empty()) {
+        return -(CHECKMATE_EVALUATION - static_cast<int>(depth));
+      }
+
+      m_ordering.score(c, moves, nullptr, depth);
+
+      int bestWeight = standPat;
+
+      for (unsigned id = 0u ; id < moves.size() ; ++id) {
+        MoveOrdering::pick(moves, id);
+        const Move& m = moves[id];
+
+        // Under-promotions are very rarely better than a queen
+        // promotion.
+        if (m.promotion != Type::None && m.promotion != Type::Queen) {
+          continue;
+        }
+
+        // Skip captures which can't raise alpha even when the
+        // position is evaluated generously.
+        if (!check && m.promotion == Type::None && standPat + evaluation::value(m.captured.type()) + DELTA_MARGIN <= alpha) {
+          continue;
+        }
+
+        m_trace.move(depth, 0u, id, m, alpha, beta);
+
+        make(b, m);
+        int w = -quiescence(oppositeColor(c), b, -beta, -alpha, depth + 1u);
+        unmake(b);
+
+        if (m_stopped) {
+          return 0;
+        }
+
+        bestWeight = std::max(bestWeight, w);
+
+        alpha = std::max(alpha, w);
+        if (alpha >= beta) {
+          m_trace.cutoff(depth, 0u, id, m, w);
+          m_pruned += moves.size() - id;
+          break;
+        }
+      }
+
+      return bestWeight;
+    }
+
+  }
+}
@@ -0,0 +1,459 @@
+#ifndef    SEARCHER_HH
+# define   SEARCHER_HH
+
+# include <array>
+# include <atomic>
+# include <vector>
+# include <core_utils/CoreObject.hh>
+# include <core_utils/TimeUtils.hh>
+# include "Board.hh"
+# include "Types.hh"
+# include "TranspositionTable.hh"
+# include "MoveOrdering.hh"
+# include "Evaluator.hh"
+# include "Tablebase.hh"
+# include "Trace.hh"
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - Runs an iterative deepening alpha-beta search
+    /// on its own copy of the board. Several searchers can run
+    /// in parallel as long as they share the same table: they
+    /// then help each other through the entries they store.
+    class Searcher: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Create a new searcher.
+         * @param id - the index of the searcher. The searcher with
+         *             index `0` is the main one: its depth one
+         *             iteration always completes and it's the only
+         *             one logging its progress.
+         * @param table - the transposition table, which may be
+         *                shared with other searchers.
+         * @param limits - the budget of each search.
+         * @param pruning - the selective techniques to use.
+         * @param abort - a flag shared with other searchers which
+         *                stops the search when it is set.
+         * @param ponder - a flag shared with other searchers which
+         *                 is set while the search runs on the time
+         *                 of the opponent: the budget is only used
+         *                 once it is cleared.
+         * @param evaluator - the static evaluation of positions,
+         *                    owned by the searcher.
+         * @param tablebase - the tables of the solved endgames, or
+         *                    null if they are not available.
+         */
+        Searcher(unsigned id,
+                 TranspositionTable& table,
+                 const SearchLimits& limits,
+                 const Pruning& pruning,
+                 const std::atomic<bool>& abort,
+                 const std::atomic<bool>& ponder,
+                 std::unique_ptr<Evaluator> evaluator,
+                 TablebaseShPtr tablebase);
+
+        /**
+         * @brief - Search the position by increasing the depth
+         *          one ply at a time until the budget is used
+         *          or the abort flag is set. The budget is not
+         *          used as long as the ponder flag is set.
+         * @param c - the color to move.
+         * @param b - the position to search.
+         * @param moves - the moves available in the position. It
+         *                is sorted by the last complete iteration
+         *                with the best move first.
+         * @param start - the time at which the search started.
+         * @param first - the depth of the first iteration.
+         * @return - the depth of the last complete iteration.
+         */
+        unsigned
+        run(const Color& c,
+            const Board& b,
+            MoveList& moves,
+            const utils::TimeStamp& start,
+            unsigned first) noexcept;
+
+        /**
+         * @brief - Returns the expected line of play found by the
+         *          last complete iteration.
+         * @return - the principal variation.
+         */
+        const MoveList&
+        principalVariation() const noexcept;
+
+        /**
+         * @brief - Returns the number of nodes visited by the last
+         *          search.
+         * @return - the number of nodes.
+         */
+        std::uint64_t
+        nodes() const noexcept;
+
+        /**
+         * @brief - Returns the number of moves skipped by the last
+         *          search thanks to the alpha-beta pruning.
+         * @return - the number of moves skipped.
+         */
+        std::uint64_t
+        pruned() const noexcept;
+
+        /**
+         * @brief - Returns the statistics about the use of the
+         *          transposition table by the last search.
+         * @return - the statistics.
+         */
+        const TableStats&
+        stats() const noexcept;
+
+        /**
+         * @brief - Returns the number of nodes visited by the
+         *          quiescence search during the last search. They
+         *          are included in the total number of nodes.
+         * @return - the number of quiescence nodes.
+         */
+        std::uint64_t
+        quiescenceNodes() const noexcept;
+
+        /**
+         * @brief - Returns the number of nodes of the last search
+         *          where a move exceeded beta.
+         * @return - the number of cutoffs.
+         */
+        std::uint64_t
+        cutoffs() const noexcept;
+
+        /**
+         * @brief - Returns the number of cutoffs of the last search
+         *          produced by the first move searched.
+         * @return - the number of cutoffs on the first move.
+         */
+        std::uint64_t
+        firstMoveCutoffs() const noexcept;
+
+        /**
+         * @brief - Returns the statistics of the iterations which
+         *          completed during the last search.
+         * @return - the statistics of each iteration.
+         */
+        const std::vector<IterationStats>&
+        iterations() const noexcept;
+
+        /**
+         * @brief - Enable or disable the recording of the events
+         *          of the next searches.
+         * @param enabled - `true` to record the events.
+         */
+        void
+        setTracing(bool enabled);
+
+        /**
+         * @brief - Returns the events recorded by the last search.
+         *          Should not be called while searching.
+         * @return - the events of the search.
+         */
+        const TraceBuffer&
+        trace() const noexcept;
+
+      private:
+
+        /**
+         * @brief - Search all the moves available at the root of
+         *          the tree at the current depth and update their
+         *          weight. The best move is placed first.
+         *          The weights are not reliable if the search was
+         *          stopped.
+         * @param b - the starting position of the board.
+         * @param moves - the moves to search, in the order in
+         *                which they should be explored.
+         * @param alpha - the lower bound of the search window.
+         * @param beta - the upper bound of the search window.
+         * @return - the score of the best move. It is a bound if
+         *           it is not strictly within the window.
+         */
+        int
+        search(const Board& b,
+               MoveList& moves,
+               int alpha,
+               int beta) noexcept;
+
+        /**
+         * @brief - Register the input move as the best one at the
+         *          ply, followed by the line of the next ply.
+         * @param ply - the distance to the root of the search.
+         * @param m - the move.
+         */
+        void
+        updatePV(unsigned ply, const Move& m) noexcept;
+
+        /**
+         * @brief - Make the move on the board and let the evaluator
+         *          know about it. The information needed to unmake
+         *          the move is pushed on the stack of the searcher.
+         * @param b - the board.
+         * @param m - the move.
+         */
+        void
+        make(Board& b, const Move& m) noexcept;
+
+        /**
+         * @brief - Unmake the last move made on the board and let
+         *          the evaluator know about it.
+         * @param b - the board.
+         */
+        void
+        unmake(Board& b) noexcept;
+
+        /**
+         * @brief - Determine whether the search should be stopped
+         *          because its budget is exhausted or because it
+         *          was aborted. The search at depth one of the main
+         *          searcher is never stopped so that a move is
+         *          always available.
+         * @return - `true` if the search should stop.
+         */
+        bool
+        stop() noexcept;
+
+        /**
+         * @brief - Search a node of the tree and record its entry
+         *          and its score when tracing is enabled. See the
+         *          `evaluateNode` method for the arguments.
+         * @return - the evaluation of the board from the point of
+         *           view of the input color.
+         */
+        int
+        evaluate(const Color& c,
+                 Board& b,
+                 int alpha,
+                 int beta,
+                 unsigned depth,
+                 unsigned remaining,
+                 bool null) noexcept;
+
+        /**
+         * @brief - Evaluate the best move for the current depth by
+         *          generating more moves if needed and aggregating
+         *          the result.
+         *          We use a minimax approach with a alpha-beta to
+         *          prune suboptimal results. The results are stored
+         *          in the transposition table, which is also probed
+         *          before exploring a position.
+         * @param c - the color for which the move should be found.
+         * @param b - the current state of the board. Moves are made
+         *            and unmade on it so it is restored when the
+         *            method returns.
+         * @param alpha - used for alpha-beta pruning, characterizes the
+         *                minimum score that the maximizing player is
+         *                assured of.
+         * @param beta - used for alpha beta pruning. Defines the
+         *               maximum score that the minimizing player is
+         *               assured of.
+         * @param depth - the current depth of the evaluation.
+         * @param remaining - the number of plies to search before
+         *                    reaching the quiescence search.
+         * @param null - whether a null move can be tried: this is
+         *               not the case right after another one.
+         * @return - the evaluation of the current state of the board
+         *           after all possible moves up until the input depth,
+         *           from the point of view of the input color.
+         */
+        int
+        evaluateNode(const Color& c,
+                     Board& b,
+                     int alpha,
+                     int beta,
+                     unsigned depth,
+                     unsigned remaining,
+                     bool null) noexcept;
+
+        /**
+         * @brief - Search a node of the quiescence search and record
+         *          its entry and its score when tracing is enabled.
+         *          See the `quiescenceNode` method for the arguments.
+         * @return - the evaluation of the board from the point of
+         *           view of the input color.
+         */
+        int
+        quiescence(const Color& c,
+                   Board& b,
+                   int alpha,
+                   int beta,
+                   unsigned depth) noexcept;
+
+        /**
+         * @brief - Extend the search at the end of the main tree
+         *          by only considering captures, or all the moves
+         *          when in check, so that the board is evaluated
+         *          in a quiet position.
+         *          The side to move can always decide to stand
+         *          pat instead of capturing when not in check.
+         * @param c - the color to move.
+         * @param b - the current state of the board.
+         * @param alpha - the lower bound of the search window.
+         * @param beta - the upper bound of the search window.
+         * @param depth - the distance to the root of the search.
+         * @return - the evaluation of the board from the point of
+         *           view of the input color.
+         */
+        int
+        quiescenceNode(const Color& c,
+                       Board& b,
+                       int alpha,
+                       int beta,
+                       unsigned depth) noexcept;
+
+      private:
+
+        /**
+         * @brief - The index of the searcher, `0` for the main one.
+         */
+        unsigned m_id;
+
+        /**
+         * @brief - The table storing the results of the search.
+         */
+        TranspositionTable& m_table;
+
+        /**
+         * @brief - The budget of each search.
+         */
+        SearchLimits m_limits;
+
+        /**
+         * @brief - The selective techniques used by the search.
+         */
+        Pruning m_pruning;
+
+        /**
+         * @brief - Set when all the searchers should stop.
+         */
+        const std::atomic<bool>& m_abort;
+
+        /**
+         * @brief - Set while the search should ignore its budget.
+         */
+        const std::atomic<bool>& m_ponder;
+
+        /**
+         * @brief - The static evaluation of the positions.
+         */
+        std::unique_ptr<Evaluator> m_evaluator;
+
+        /**
+         * @brief - The tables of the solved endgames, shared by all
+         *          the searchers. May be null.
+         */
+        TablebaseShPtr m_tablebase;
+
+        /**
+         * @brief - The color to move at the root of the search.
+         */
+        Color m_color;
+
+        /***
+         * @brief - The depth of the current iteration of the search.
+         */
+        unsigned m_depth;
+
+        /**
+         * @brief - The time at which the current search started.
+         */
+        utils::TimeStamp m_start;
+
+        /**
+         * @brief - The number of nodes visited by the current
+         *          search.
+         */
+        std::uint64_t m_nodes;
+
+        /**
+         * @brief - The number of moves skipped thanks to the
+         *          alpha-beta pruning in the current search.
+         */
+        std::uint64_t m_pruned;
+
+        /**
+         * @brief - The number of nodes visited by the quiescence
+         *          search in the current search.
+         */
+        std::uint64_t m_quiescence;
+
+        /**
+         * @brief - The number of cutoffs in the current search.
+         */
+        std::uint64_t m_cutoffs;
+
+        /**
+         * @brief - The number of cutoffs produced by the first move
+         *          in the current search.
+         */
+        std::uint64_t m_firstMoveCutoffs;
+
+        /**
+         * @brief - The statistics of the iterations completed by
+         *          the current search.
+         */
+        std::vector<IterationStats> m_iterations;
+
+        /**
+         * @brief - Whether the current search ran out of budget.
+         */
+        bool m_stopped;
+
+        /**
+         * @brief - The statistics about the use of the table by
+         *          the current search.
+         */
+        TableStats m_stats;
+
+        /**
+         * @brief - The heuristics used to search the best moves
+         *          first.
+         */
+        MoveOrdering m_ordering;
+
+        /**
+         * @brief - The best line found so far from each ply of the
+         *          search: the line of a ply starts at the index of
+         *          the ply.
+         */
+        std::array<std::array<Move, MAX_PLY>, MAX_PLY> m_pv;
+
+        /**
+         * @brief - The index of the end of the line of each ply.
+         */
+        std::array<unsigned, MAX_PLY> m_pvLength;
+
+        /**
+         * @brief - The principal variation of the last complete
+         *          iteration.
+         */
+        MoveList m_line;
+
+        /**
+         * @brief - The information needed to unmake the moves made
+         *          on the board of the search, one per ply. The board
+         *          is copied at the root of each search so it should
+         *          not hold them itself.
+         */
+        std::array<UndoRecord, MAX_PLY> m_undo;
+
+        /**
+         * @brief - The number of moves currently made on the board
+         *          of the search.
+         */
+        unsigned m_undoCount;
+
+        /**
+         * @brief - The events recorded by the current search when
+         *          tracing is enabled.
+         */
+        TraceBuffer m_trace;
+    };
+
+  }
+}
+
+#endif    /* SEARCHER_HH */
@@ -0,0 +1,208 @@
+
+# include "Tablebase.hh"
+# include <cstring>
+# include <algorithm>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "Board.hh"
+# include "Types.hh"
+
+namespace {
+
+  /**
+   * @brief - Whether a side can still castle: its king and one
+   *          of its rooks did not move yet.
+   * @param b - the board.
+   * @return - `true` if any side can castle.
+   */
+  bool
+  castling(const chess::Board& b) noexcept {
+    chess::Color colors[] = {chess::Color::White, chess::Color::Black};
+
+    for (unsigned id = 0u ; id < 2u ; ++id) {
+      const chess::Color& c = colors[id];
+      int y = (c == chess::Color::White ? 0 : 7);
+
+      const chess::Piece& king = b.at(4, y);
+      if (!king.king() || king.color() != c || b.hasMoved(chess::Coordinates(4, y))) {
+        continue;
+      }
+
+      for (int x = 0 ; x < 8 ; x += 7) {
+        const chess::Piece& rook = b.at(x, y);
+        if (rook.rook() && rook.color() == c && !b.hasMoved(chess::Coordinates(x, y))) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+}
+
+namespace chess {
+  namespace ai {
+
+    Tablebase::Tablebase(const std::string& directory):
+      utils::CoreObject("tablebase"),
+
+      m_tables(),
+      m_materials()
+    {
+      setService("ai");
+
+      std::vector<Endgame> endgames = Endgame::all();
+      for (unsigned id = 0u ; id < endgames.size() ; ++id) {
+        load(directory, endgames[id]);
+      }
+
+      info("Loaded " + std::to_string(m_tables.size()) + "/" + std::to_string(endgames.size()) + " table(s) from \"" + directory + "\"");
+    }
+
+    Tablebase::~Tablebase() {
+      for (unsigned id = 0u ; id < m_tables.size() ; ++id) {
+        ::munmap(m_tables[id].data, m_tables[id].bytes);
+      }
+    }
+
+    unsigned
+    Tablebase::size() const noexcept {
+      return static_cast<unsigned>(m_tables.size());
+    }
+
+    bool
+    Tablebase::probe(const Board& b,
+                     const Color& side,
+                     TablebaseResult& result) const noexcept
+    {
+      int count = bitboard::count(b.occupancy());
+
+      // Only the kings are left: this is a draw.
+      if (count == 2) {
+        result = TablebaseResult{0, 0u};
+        return true;
+      }
+
+      if (m_tables.empty() || count > static_cast<int>(TABLEBASE_MAX_PIECES)) {
+        return false;
+      }
+
+      // The tables don't know about en passant captures.
+      Bitboard ep = b.enPassant();
+      if (ep != 0u) {
+        int cell = bitboard::first(ep);
+        if ((bitboard::pawnAttacks(oppositeColor(side), cell) & b.bitboard(side, Type::Pawn)) != 0u) {
+          return false;
+        }
+      }
+
+      if (castling(b)) {
+        return false;
+      }
+
+      // The table might describe the position with the colors
+      // swapped.
+      bool flip = false;
+      std::unordered_map<MaterialKey, unsigned>::const_iterator it = m_materials.find(Endgame::material(b, false));
+
+      if (it == m_materials.cend()) {
+        flip = true;
+        it = m_materials.find(Endgame::material(b, true));
+      }
+      if (it == m_materials.cend()) {
+        return false;
+      }
+
+      const Table& t = m_tables[it->second];
+      std::uint8_t entry = t.entries[t.endgame.index(b, side, flip)];
+
+      if (entry == TABLEBASE_ILLEGAL || entry == TABLEBASE_UNKNOWN) {
+        return false;
+      }
+
+      result = decode(entry);
+      return true;
+    }
+
+    TablebaseResult
+    Tablebase::decode(std::uint8_t entry) noexcept {
+      if (entry == TABLEBASE_DRAW) {
+        return TablebaseResult{0, 0u};
+      }
+
+      unsigned plies = entry - 1u;
+      return TablebaseResult{plies % 2u == 1u ? 1 : -1, plies};
+    }
+
+    std::uint8_t
+    Tablebase::encode(unsigned plies) noexcept {
+      // Keep the parity of the distance so that the winner of
+      // the position does not change.
+      if (plies > TABLEBASE_MAX_PLIES) {
+        plies = TABLEBASE_MAX_PLIES - (plies - TABLEBASE_MAX_PLIES) % 2u;
+      }
+
+      return static_cast<std::uint8_t>(plies + 1u);
+    }
+
+    int
+    Tablebase::score(const TablebaseResult& result, unsigned ply) noexcept {
+      if (result.outcome == 0) {
+        return 0;
+      }
+
+      // The score should remain recognized as a mate by the
+      // transposition table.
+      int distance = static_cast<int>(std::min(ply + result.plies, 255u));
+      int mate = CHECKMATE_EVALUATION - distance;
+
+      return (result.outcome > 0 ? mate : -mate);
+    }
+
+    void
+    Tablebase::load(const std::string& directory, const Endgame& endgame) {
+      std::string file = directory + "/" + endgame.name() + TABLEBASE_EXTENSION;
+
+      int fd = ::open(file.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return;
+      }
+
+      std::size_t header = sizeof(TABLEBASE_MAGIC) - 1u;
+      std::size_t bytes = header + endgame.size();
+
+      struct stat st;
+      if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != bytes) {
+        ::close(fd);
+        warn("Ignoring table \"" + file + "\"", "Unexpected size");
+
+        return;
+      }
+
+      // The mapping remains valid once the file is closed.
+      void* data = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+
+      if (data == MAP_FAILED) {
+        warn("Ignoring table \"" + file + "\"", "Failed to map file");
+        return;
+      }
+
+      if (std::memcmp(data, TABLEBASE_MAGIC, header) != 0) {
+        ::munmap(data, bytes);
+        warn("Ignoring table \"" + file + "\"", "Invalid header");
+
+        return;
+      }
+
+      m_materials[endgame.material()] = static_cast<unsigned>(m_tables.size());
+      m_tables.push_back(Table{endgame, data, bytes, static_cast<const std::uint8_t*>(data) + header});
+
+      debug("Mapped table \"" + file + "\" with " + std::to_string(endgame.size()) + " position(s)");
+    }
+
+  }
+}
@@ -0,0 +1,169 @@
+#ifndef    TABLEBASE_HH
+# define   TABLEBASE_HH
+
+# include <memory>
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <core_utils/CoreObject.hh>
+# include "Endgame.hh"
+
+/// @brief - The bytes at the start of a table file, followed
+/// by one byte for each position of the endgame.
+# define TABLEBASE_MAGIC "CHESSTB1"
+
+/// @brief - The extension of the table files, which are named
+/// after their endgame.
+# define TABLEBASE_EXTENSION ".tb"
+
+/// @brief - The entry of a drawn position. Other positions are
+/// stored as the number of plies to mate plus one: the side to
+/// move wins when it is odd and loses when it is even.
+# define TABLEBASE_DRAW 0u
+
+/// @brief - The entry of a position not solved yet while the
+/// table is generated.
+# define TABLEBASE_UNKNOWN 254u
+
+/// @brief - The entry of a position which can't be reached.
+# define TABLEBASE_ILLEGAL 255u
+
+/// @brief - The maximum number of plies to mate which can be
+/// stored in an entry.
+# define TABLEBASE_MAX_PLIES 252u
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - The value of a position in the tablebases, from
+    /// the point of view of the side to move.
+    struct TablebaseResult {
+      // `1` if the side to move wins, `-1` if it loses and `0`
+      // for a draw.
+      int outcome;
+
+      // The number of plies before the mate, `0` for a draw.
+      unsigned plies;
+    };
+
+    /// @brief - Gives access to the distance to mate of the
+    /// positions with few pieces. The tables are generated by
+    /// `chess_tbgen` and mapped in memory: they are only read
+    /// from the disk when they are accessed.
+    /// The tables ignore castling and en passant: positions
+    /// where one of them is possible are not probed.
+    class Tablebase: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Map the tables available in the input folder.
+         *          Missing tables are ignored and invalid ones are
+         *          reported and ignored.
+         * @param directory - the folder containing the tables.
+         */
+        Tablebase(const std::string& directory);
+
+        ~Tablebase();
+
+        Tablebase(const Tablebase&) = delete;
+
+        Tablebase&
+        operator=(const Tablebase&) = delete;
+
+        /**
+         * @brief - Returns the number of tables available.
+         * @return - the number of tables.
+         */
+        unsigned
+        size() const noexcept;
+
+        /**
+         * @brief - Look for the input position in the tables.
+         * @param b - the board.
+         * @param side - the side to move.
+         * @param result - output argument receiving the value of
+         *                 the position.
+         * @return - `true` if the position was found.
+         */
+        bool
+        probe(const Board& b,
+              const Color& side,
+              TablebaseResult& result) const noexcept;
+
+        /**
+         * @brief - Convert an entry of a table into the value of
+         *          the position.
+         * @param entry - the entry, which should not be illegal or
+         *                unknown.
+         * @return - the value of the position.
+         */
+        static
+        TablebaseResult
+        decode(std::uint8_t entry) noexcept;
+
+        /**
+         * @brief - Convert the number of plies before the mate into
+         *          an entry of a table.
+         * @param plies - the number of plies, odd if the side to move
+         *                wins. Clamped to the maximum supported.
+         * @return - the entry.
+         */
+        static
+        std::uint8_t
+        encode(unsigned plies) noexcept;
+
+        /**
+         * @brief - Convert the value of a position into a score of
+         *          the search, similar to a mate found by the search.
+         * @param result - the value of the position.
+         * @param ply - the distance to the root of the search.
+         * @return - the score.
+         */
+        static
+        int
+        score(const TablebaseResult& result, unsigned ply) noexcept;
+
+      private:
+
+        /// @brief - A table mapped in memory.
+        struct Table {
+          // The endgame described by the table.
+          Endgame endgame;
+
+          // The start of the mapping.
+          void* data;
+
+          // The size of the mapping in bytes.
+          std::size_t bytes;
+
+          // The entries of the positions, after the header.
+          const std::uint8_t* entries;
+        };
+
+        /**
+         * @brief - Map the table of the input endgame if it exists.
+         * @param directory - the folder containing the tables.
+         * @param endgame - the endgame.
+         */
+        void
+        load(const std::string& directory, const Endgame& endgame);
+
+      private:
+
+        /**
+         * @brief - The tables available.
+         */
+        std::vector<Table> m_tables;
+
+        /**
+         * @brief - The index of the table of each material.
+         */
+        std::unordered_map<MaterialKey, unsigned> m_materials;
+    };
+
+    using TablebaseShPtr = std::shared_ptr<const Tablebase>;
+
+  }
+}
+
+#endif    /* TABLEBASE_HH */
@@ -0,0 +1,154 @@
+
+# include "Trace.hh"
+# include <fstream>
+# include <cstring>
+# include <algorithm>
+
+namespace chess {
+  namespace ai {
+
+    static_assert(sizeof(TraceRecord) == 16u, "Trace records should be packed in 16 bytes");
+    static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1u)) == 0u, "Trace capacity should be a power of two");
+
+    TraceBuffer::TraceBuffer() noexcept:
+      m_enabled(false),
+      m_head(0u),
+      m_records()
+    {}
+
+    void
+    TraceBuffer::reset(bool enabled) {
+      m_head = 0u;
+
+      if (enabled && m_records == nullptr) {
+        // The events are not initialized: only the pages which
+        // are written to are actually allocated.
+        m_records.reset(new TraceRecord[TRACE_CAPACITY]);
+      }
+      if (!enabled) {
+        m_records.reset();
+      }
+
+      m_enabled = enabled;
+    }
+
+    ThreadTrace
+    TraceBuffer::snapshot(unsigned thread) const {
+      ThreadTrace out{thread, m_head, {}};
+      if (m_records == nullptr) {
+        return out;
+      }
+
+      // Once the buffer wrapped around, the oldest event is the
+      // one which will be overwritten next.
+      std::uint64_t count = std::min<std::uint64_t>(m_head, TRACE_CAPACITY);
+      std::uint64_t first = m_head - count;
+
+      out.records.resize(count);
+      for (std::uint64_t id = 0u ; id < count ; ++id) {
+        out.records[id] = m_records[(first + id) & (TRACE_CAPACITY - 1u)];
+      }
+
+      return out;
+    }
+
+    TraceFile::TraceFile(const std::string& file):
+      utils::CoreObject("trace"),
+
+      m_file(file)
+    {
+      setService("ai");
+    }
+
+    void
+    TraceFile::save(const std::vector<ThreadTrace>& threads) {
+      std::ofstream out(m_file, std::ios::binary | std::ios::trunc);
+      if (!out.good()) {
+        error("Failed to save trace to \"" + m_file + "\"", "Unable to open file");
+      }
+
+      auto write = [&out](const void* data, std::size_t bytes) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+      };
+
+      write(TRACE_MAGIC, sizeof(TRACE_MAGIC) - 1u);
+
+      std::uint32_t count = static_cast<std::uint32_t>(threads.size());
+      write(&count, sizeof(count));
+
+      for (unsigned id = 0u ; id < threads.size() ; ++id) {
+        const ThreadTrace& t = threads[id];
+
+        std::uint32_t thread = t.thread;
+        std::uint64_t events = t.events;
+        std::uint64_t records = t.records.size();
+
+        write(&thread, sizeof(thread));
+        write(&events, sizeof(events));
+        write(&records, sizeof(records));
+        write(t.records.data(), t.records.size() * sizeof(TraceRecord));
+      }
+
+      if (!out.good()) {
+        error("Failed to save trace to \"" + m_file + "\"", "Unable to write file");
+      }
+    }
+
+    std::vector<ThreadTrace>
+    TraceFile::load() {
+      std::ifstream in(m_file, std::ios::binary);
+      if (!in.good()) {
+        error("Failed to load trace from \"" + m_file + "\"", "Unable to open file");
+      }
+
+      char magic[sizeof(TRACE_MAGIC) - 1u];
+      in.read(magic, sizeof(magic));
+      if (!in.good() || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        error("Failed to load trace from \"" + m_file + "\"", "Invalid header");
+      }
+
+      auto read = [&in](void* data, std::size_t bytes) {
+        in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        return in.good();
+      };
+
+      std::uint32_t count = 0u;
+      if (!read(&count, sizeof(count))) {
+        error("Failed to load trace from \"" + m_file + "\"", "File is too short");
+      }
+
+      std::vector<ThreadTrace> threads;
+
+      for (unsigned id = 0u ; id < count ; ++id) {
+        std::uint32_t thread = 0u;
+        std::uint64_t events = 0u;
+        std::uint64_t records = 0u;
+
+        bool valid =
+          read(&thread, sizeof(thread)) &&
+          read(&events, sizeof(events)) &&
+          read(&records, sizeof(records)) &&
+          records <= TRACE_CAPACITY &&
+          records <= events;
+
+        if (!valid) {
+          error("Failed to load trace from \"" + m_file + "\"", "Invalid thread " + std::to_string(id));
+        }
+
+        ThreadTrace t{thread, events, std::vector<TraceRecord>(records)};
+        if (!read(t.records.data(), t.records.size() * sizeof(TraceRecord))) {
+          error("Failed to load trace from \"" + m_file + "\"", "File is too short");
+        }
+
+        threads.push_back(std::move(t));
+      }
+
+      if (in.peek() != std::ifstream::traits_type::eof()) {
+        error("Failed to load trace from \"" + m_file + "\"", "File is too long");
+      }
+
+      return threads;
+    }
+
+  }
+}
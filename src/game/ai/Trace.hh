@@ -0,0 +1,254 @@
+#ifndef    TRACE_HH
+# define   TRACE_HH
+
+# include <memory>
+# include <string>
+# include <vector>
+# include <cstdint>
+# include <core_utils/CoreObject.hh>
+# include "Zobrist.hh"
+# include "Types.hh"
+
+/// @brief - The header of the files holding the trace of a
+/// search.
+# define TRACE_MAGIC "CHSTRC01"
+
+/// @brief - The number of events kept for each thread: older
+/// events are overwritten once it is reached. Must be a power
+/// of two.
+# define TRACE_CAPACITY (1u << 20u)
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - The events recorded by the search.
+    enum class TraceEvent: std::uint8_t {
+      Enter,
+      Move,
+      Cutoff,
+      Return
+    };
+
+    /// @brief - An event of the search, packed so that it can
+    /// be recorded at each node without slowing down the search.
+    struct TraceRecord {
+      // The type of the event.
+      TraceEvent event;
+
+      // The distance to the root of the search.
+      std::uint8_t ply;
+
+      // The number of plies to search before reaching the
+      // quiescence search, `0` in the quiescence search.
+      std::uint8_t remaining;
+
+      // The index of the move in the order of the search for
+      // the `Move` and `Cutoff` events.
+      std::uint8_t index;
+
+      // The move for the `Move` and `Cutoff` events: the start
+      // cell in the first six bits, the end cell in the next
+      // six and the type of the promotion in the last four.
+      std::uint16_t move;
+
+      // The score of the node for the `Return` event and of the
+      // move for the `Cutoff` event.
+      std::int16_t score;
+
+      // The lower bound of the window of the node.
+      std::int16_t alpha;
+
+      // The upper bound of the window of the node.
+      std::int16_t beta;
+
+      // The lowest bits of the key of the position for the
+      // `Enter` event.
+      std::uint32_t key;
+    };
+
+    /// @brief - The events recorded by one thread, as read from
+    /// a trace file.
+    struct ThreadTrace {
+      // The index of the searcher.
+      unsigned thread;
+
+      // The number of events recorded, including the ones which
+      // were overwritten.
+      std::uint64_t events;
+
+      // The events kept, from the oldest to the most recent.
+      std::vector<TraceRecord> records;
+    };
+
+    /// @brief - A ring buffer recording the events of the search
+    /// of a single thread. It belongs to the thread of a searcher
+    /// and is only read once the search is over: recording is a
+    /// copy of the event, without any synchronization. Nothing is
+    /// recorded when the buffer is disabled.
+    class TraceBuffer {
+      public:
+
+        /**
+         * @brief - Create a disabled buffer.
+         */
+        TraceBuffer() noexcept;
+
+        /**
+         * @brief - Forget the events recorded so far and enable or
+         *          disable the recording. The memory of the buffer
+         *          is only allocated while it is enabled.
+         * @param enabled - `true` to record the next events.
+         */
+        void
+        reset(bool enabled);
+
+        /**
+         * @brief - Whether the events are recorded.
+         * @return - `true` if the buffer is enabled.
+         */
+        bool
+        enabled() const noexcept;
+
+        /**
+         * @brief - Returns the number of events recorded since the
+         *          last reset, including the overwritten ones.
+         * @return - the number of events.
+         */
+        std::uint64_t
+        size() const noexcept;
+
+        /**
+         * @brief - Record the entry in a node of the search.
+         * @param ply - the distance to the root.
+         * @param remaining - the depth left to search.
+         * @param key - the key of the position.
+         * @param alpha - the lower bound of the window.
+         * @param beta - the upper bound of the window.
+         */
+        void
+        enter(unsigned ply, unsigned remaining, Key key, int alpha, int beta) noexcept;
+
+        /**
+         * @brief - Record a move about to be searched.
+         * @param ply - the distance to the root.
+         * @param remaining - the depth left to search.
+         * @param index - the index of the move in the order of the
+         *                search.
+         * @param m - the move.
+         * @param alpha - the lower bound of the window.
+         * @param beta - the upper bound of the window.
+         */
+        void
+        move(unsigned ply, unsigned remaining, unsigned index, const Move& m, int alpha, int beta) noexcept;
+
+        /**
+         * @brief - Record a move exceeding beta.
+         * @param ply - the distance to the root.
+         * @param remaining - the depth left to search.
+         * @param index - the index of the move in the order of the
+         *                search.
+         * @param m - the move.
+         * @param score - the score of the move.
+         */
+        void
+        cutoff(unsigned ply, unsigned remaining, unsigned index, const Move& m, int score) noexcept;
+
+        /**
+         * @brief - Record the score returned by a node.
+         * @param ply - the distance to the root.
+         * @param remaining - the depth left to search.
+         * @param score - the score of the node.
+         */
+        void
+        leave(unsigned ply, unsigned remaining, int score) noexcept;
+
+        /**
+         * @brief - Copy the events kept by the buffer.
+         * @param thread - the index of the thread owning the buffer.
+         * @return - the events, from the oldest to the most recent.
+         */
+        ThreadTrace
+        snapshot(unsigned thread) const;
+
+        /**
+         * @brief - Pack a move in the format of the records.
+         * @param m - the move.
+         * @return - the packed move.
+         */
+        static
+        std::uint16_t
+        pack(const Move& m) noexcept;
+
+      private:
+
+        /**
+         * @brief - Record an event, overwriting the oldest one if
+         *          the buffer is full.
+         * @param r - the event.
+         */
+        void
+        push(const TraceRecord& r) noexcept;
+
+      private:
+
+        /**
+         * @brief - Whether the events are recorded.
+         */
+        bool m_enabled;
+
+        /**
+         * @brief - The number of events recorded since the last
+         *          reset. The next one is written at this index
+         *          modulo the capacity.
+         */
+        std::uint64_t m_head;
+
+        /**
+         * @brief - The events, null while the buffer is disabled.
+         */
+        std::unique_ptr<TraceRecord[]> m_records;
+    };
+
+    /// @brief - A file holding the events recorded by all the
+    /// threads of a search. The records are written as they are
+    /// in memory, which assumes a little endian machine.
+    class TraceFile: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Create a trace file.
+         * @param file - the path to the file.
+         */
+        TraceFile(const std::string& file);
+
+        /**
+         * @brief - Write the events of all the threads to the file,
+         *          replacing its content. Raises an error in case
+         *          the file can't be written.
+         * @param threads - the events of each thread.
+         */
+        void
+        save(const std::vector<ThreadTrace>& threads);
+
+        /**
+         * @brief - Read the events of all the threads from the file.
+         *          Raises an error in case the file is invalid.
+         * @return - the events of each thread.
+         */
+        std::vector<ThreadTrace>
+        load();
+
+      private:
+
+        /**
+         * @brief - The path to the file.
+         */
+        std::string m_file;
+    };
+
+  }
+}
+
+# include "Trace.hxx"
+
+#endif    /* TRACE_HH */
@@ -0,0 +1,128 @@
+#ifndef    TRACE_HXX
+# define   TRACE_HXX
+
+# include "Trace.hh"
+
+namespace chess {
+  namespace ai {
+
+    inline
+    bool
+    TraceBuffer::enabled() const noexcept {
+      return m_enabled;
+    }
+
+    inline
+    std::uint64_t
+    TraceBuffer::size() const noexcept {
+      return m_head;
+    }
+
+    inline
+    void
+    TraceBuffer::enter(unsigned ply, unsigned remaining, Key key, int alpha, int beta) noexcept {
+      if (!m_enabled) {
+        return;
+      }
+
+      push(
+        TraceRecord{
+          TraceEvent::Enter,
+          static_cast<std::uint8_t>(ply),
+          static_cast<std::uint8_t>(remaining),
+          0u,
+          0u,
+          0,
+          static_cast<std::int16_t>(alpha),
+          static_cast<std::int16_t>(beta),
+          static_cast<std::uint32_t>(key)
+        }
+      );
+    }
+
+    inline
+    void
+    TraceBuffer::move(unsigned ply, unsigned remaining, unsigned index, const Move& m, int alpha, int beta) noexcept {
+      if (!m_enabled) {
+        return;
+      }
+
+      push(
+        TraceRecord{
+          TraceEvent::Move,
+          static_cast<std::uint8_t>(ply),
+          static_cast<std::uint8_t>(remaining),
+          static_cast<std::uint8_t>(index),
+          pack(m),
+          0,
+          static_cast<std::int16_t>(alpha),
+          static_cast<std::int16_t>(beta),
+          0u
+        }
+      );
+    }
+
+    inline
+    void
+    TraceBuffer::cutoff(unsigned ply, unsigned remaining, unsigned index, const Move& m, int score) noexcept {
+      if (!m_enabled) {
+        return;
+      }
+
+      push(
+        TraceRecord{
+          TraceEvent::Cutoff,
+          static_cast<std::uint8_t>(ply),
+          static_cast<std::uint8_t>(remaining),
+          static_cast<std::uint8_t>(index),
+          pack(m),
+          static_cast<std::int16_t>(score),
+          0,
+          0,
+          0u
+        }
+      );
+    }
+
+    inline
+    void
+    TraceBuffer::leave(unsigned ply, unsigned remaining, int score) noexcept {
+      if (!m_enabled) {
+        return;
+      }
+
+      push(
+        TraceRecord{
+          TraceEvent::Return,
+          static_cast<std::uint8_t>(ply),
+          static_cast<std::uint8_t>(remaining),
+          0u,
+          0u,
+          static_cast<std::int16_t>(score),
+          0,
+          0,
+          0u
+        }
+      );
+    }
+
+    inline
+    std::uint16_t
+    TraceBuffer::pack(const Move& m) noexcept {
+      unsigned start = static_cast<unsigned>(m.start.y() * 8 + m.start.x());
+      unsigned end = static_cast<unsigned>(m.end.y() * 8 + m.end.x());
+
+      return static_cast<std::uint16_t>(start | (end << 6u) | (static_cast<unsigned>(m.promotion) << 12u));
+    }
+
+    inline
+    void
+    TraceBuffer::push(const TraceRecord& r) noexcept {
+      m_records[m_head & (TRACE_CAPACITY - 1u)] = r;
+      ++m_head;
+    }
+
+  }
+}
+
+#endif    /* TRACE_HXX */
@@ -0,0 +1,164 @@
+
+
+# include "TranspositionTable.hh"
+# include <algorithm>
+
+/// @brief - Layout of the data of an entry: the best move
+/// uses the 15 lowest bits, followed by the score (16 bits),
+/// the depth (8 bits), the bound (2 bits) and the generation
+/// of the search (8 bits).
+# define MOVE_START_SHIFT 0u
+# define MOVE_END_SHIFT 6u
+# define PROMOTION_SHIFT 12u
+# define SCORE_SHIFT 16u
+# define DEPTH_SHIFT 32u
+# define BOUND_SHIFT 40u
+# define GENERATION_SHIFT 42u
+
+namespace chess {
+  namespace ai {
+
+    TranspositionTable::TranspositionTable(unsigned sizeMB):
+      utils::CoreObject("table"),
+
+      m_slots(),
+      m_count(0u),
+      m_mask(0u),
+      m_generation(0u)
+    {
+      setService("ai");
+
+      resize(sizeMB);
+    }
+
+    void
+    TranspositionTable::resize(unsigned sizeMB) {
+      // Find the largest power of two number of entries which
+      // fits in the budget.
+      std::size_t budget = static_cast<std::size_t>(sizeMB) * 1024u * 1024u;
+      std::size_t count = 1u;
+
+      while (2u * count * sizeof(Slot) <= budget) {
+        count *= 2u;
+      }
+
+      m_slots = std::make_unique<Slot[]>(count);
+      m_count = count;
+      m_mask = count - 1u;
+
+      clear();
+
+      debug("Allocated " + std::to_string(count) + " entrie(s) in transposition table (" + std::to_string(sizeMB) + "MB)");
+    }
+
+    void
+    TranspositionTable::clear() noexcept {
+      for (std::size_t id = 0u ; id < m_count ; ++id) {
+        m_slots[id].key.store(0u, std::memory_order_relaxed);
+        m_slots[id].data.store(0u, std::memory_order_relaxed);
+      }
+
+      m_generation = 0u;
+    }
+
+    void
+    TranspositionTable::newSearch() noexcept {
+      m_generation = (m_generation + 1u) % 256u;
+    }
+
+    bool
+    TranspositionTable::probe(const Key& key,
+                              HashEntry& entry,
+                              TableStats& stats) const noexcept
+    {
+      const Slot& s = m_slots[key & m_mask];
+      ++stats.probes;
+
+      std::uint64_t data = s.data.load(std::memory_order_relaxed);
+      Key k = s.key.load(std::memory_order_relaxed) ^ data;
+
+      // Empty slots have no data.
+      if (data == 0u) {
+        return false;
+      }
+
+      // Either another position or an entry being written by
+      // another thread.
+      if (k != key) {
+        ++stats.collisions;
+        return false;
+      }
+
+      ++stats.hits;
+      entry = unpack(data);
+
+      return true;
+    }
+
+    void
+    TranspositionTable::store(TableStats& stats,
+                              const Key& key,
+                              const HashEntry& entry) noexcept
+    {
+      Slot& s = m_slots[key & m_mask];
+
+      std::uint64_t data = s.data.load(std::memory_order_relaxed);
+      Key k = s.key.load(std::memory_order_relaxed) ^ data;
+
+      // Keep the existing entry if it is for another position
+      // of the current search and was searched deeper.
+      if (data != 0u && k != key && generation(data) == m_generation) {
+        HashEntry existing = unpack(data);
+        if (existing.depth > entry.depth) {
+          return;
+        }
+      }
+
+      data = pack(entry, m_generation);
+      s.key.store(key ^ data, std::memory_order_relaxed);
+      s.data.store(data, std::memory_order_relaxed);
+
+      ++stats.stores;
+    }
+
+    std::size_t
+    TranspositionTable::size() const noexcept {
+      return m_count;
+    }
+
+    std::uint64_t
+    TranspositionTable::pack(const HashEntry& entry, unsigned generation) noexcept {
+      std::uint64_t out = 0u;
+
+      out |= static_cast<std::uint64_t>(entry.start & 0x3Fu) << MOVE_START_SHIFT;
+      out |= static_cast<std::uint64_t>(entry.end & 0x3Fu) << MOVE_END_SHIFT;
+      out |= static_cast<std::uint64_t>(static_cast<unsigned>(entry.promotion) & 0x7u) << PROMOTION_SHIFT;
+      out |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.score)) << SCORE_SHIFT;
+      out |= static_cast<std::uint64_t>(std::min(entry.depth, 255u)) << DEPTH_SHIFT;
+      out |= static_cast<std::uint64_t>(static_cast<unsigned>(entry.bound) & 0x3u) << BOUND_SHIFT;
+      out |= static_cast<std::uint64_t>(generation & 0xFFu) << GENERATION_SHIFT;
+
+      return out;
+    }
+
+    HashEntry
+    TranspositionTable::unpack(std::uint64_t data) noexcept {
+      HashEntry out;
+
+      out.start = (data >> MOVE_START_SHIFT) & 0x3Fu;
+      out.end = (data >> MOVE_END_SHIFT) & 0x3Fu;
+      out.promotion = static_cast<Type>((data >> PROMOTION_SHIFT) & 0x7u);
+      out.score = static_cast<std::int16_t>((data >> SCORE_SHIFT) & 0xFFFFu);
+      out.depth = (data >> DEPTH_SHIFT) & 0xFFu;
+      out.bound = static_cast<Bound>((data >> BOUND_SHIFT) & 0x3u);
+
+      return out;
+    }
+
+    unsigned
+    TranspositionTable::generation(std::uint64_t data) noexcept {
+      return (data >> GENERATION_SHIFT) & 0xFFu;
+    }
+
+  }
+}
@@ -0,0 +1,186 @@
+#ifndef    TRANSPOSITION_TABLE_HH
+# define   TRANSPOSITION_TABLE_HH
+
+# include <atomic>
+# include <memory>
+# include <cstdint>
+# include <core_utils/CoreObject.hh>
+# include "Zobrist.hh"
+# include "Piece.hh"
+
+namespace chess {
+  namespace ai {
+
+    /// @brief - The meaning of a score stored in the table.
+    enum class Bound {
+      None,
+      Exact,
+      Lower,
+      Upper
+    };
+
+    /// @brief - The information stored for a position.
+    struct HashEntry {
+      // The remaining depth of the search which produced
+      // the score.
+      unsigned depth;
+
+      // Whether the score is exact or a bound.
+      Bound bound;
+
+      // The score of the position. Mate scores are relative
+      // to the position and not to the root of the search.
+      int score;
+
+      // The linear index of the starting cell of the best
+      // move. Equal to `end` when no move is known.
+      unsigned start;
+
+      // The linear index of the ending cell of the best move.
+      unsigned end;
+
+      // The promotion of the best move.
+      Type promotion;
+    };
+
+    /// @brief - Statistics about the use of the table.
+    struct TableStats {
+      // The number of lookups in the table.
+      std::uint64_t probes;
+
+      // The number of lookups which found the position.
+      std::uint64_t hits;
+
+      // The number of entries written in the table.
+      std::uint64_t stores;
+
+      // The number of lookups which found an entry for a
+      // different position.
+      std::uint64_t collisions;
+    };
+
+    /// @brief - A cache of the results of the search indexed by
+    /// the key of the positions. The table holds a power of two
+    /// number of entries, each one being 16 bytes.
+    /// The table can be shared by several threads without locks:
+    /// each entry stores the key xored with the data, so that an
+    /// entry partially written by another thread is detected as
+    /// a position which is not in the table.
+    class TranspositionTable: public utils::CoreObject {
+      public:
+
+        /**
+         * @brief - Create a table using at most the input amount
+         *          of memory.
+         * @param sizeMB - the memory budget in megabytes.
+         */
+        TranspositionTable(unsigned sizeMB);
+
+        /**
+         * @brief - Change the memory budget of the table. This
+         *          clears the content of the table.
+         * @param sizeMB - the memory budget in megabytes.
+         */
+        void
+        resize(unsigned sizeMB);
+
+        /**
+         * @brief - Removes all the entries of the table. This is
+         *          not safe to call while the table is in use.
+         */
+        void
+        clear() noexcept;
+
+        /**
+         * @brief - Notify the table that a new search starts: this
+         *          is used to prefer replacing entries from older
+         *          searches.
+         */
+        void
+        newSearch() noexcept;
+
+        /**
+         * @brief - Fetch the entry for the input key if it exists.
+         * @param key - the key of the position.
+         * @param entry - output argument receiving the entry.
+         * @param stats - the statistics of the caller, updated
+         *                with the result of the lookup.
+         * @return - `true` if the position was found.
+         */
+        bool
+        probe(const Key& key,
+              HashEntry& entry,
+              TableStats& stats) const noexcept;
+
+        /**
+         * @brief - Store the entry for the input key. The entry
+         *          replaces the existing one if it is for the same
+         *          position, comes from an older search or has a
+         *          lower depth.
+         * @param stats - the statistics of the caller.
+         * @param key - the key of the position.
+         * @param entry - the entry to store.
+         */
+        void
+        store(TableStats& stats,
+              const Key& key,
+              const HashEntry& entry) noexcept;
+
+        /**
+         * @brief - Returns the number of entries of the table.
+         * @return - the capacity of the table.
+         */
+        std::size_t
+        size() const noexcept;
+
+      private:
+
+        /// @brief - An entry of the table: the data is packed in
+        /// a single integer alongside the key xored with it. The
+        /// accesses are relaxed as the xor detects torn entries.
+        struct Slot {
+          std::atomic<Key> key;
+          std::atomic<std::uint64_t> data;
+        };
+
+        static
+        std::uint64_t
+        pack(const HashEntry& entry, unsigned generation) noexcept;
+
+        static
+        HashEntry
+        unpack(std::uint64_t data) noexcept;
+
+        static
+        unsigned
+        generation(std::uint64_t data) noexcept;
+
+      private:
+
+        /**
+         * @brief - The entries of the table.
+         */
+        std::unique_ptr<Slot[]> m_slots;
+
+        /**
+         * @brief - The number of entries of the table.
+         */
+        std::size_t m_count;
+
+        /**
+         * @brief - The mask to apply to the key to get the index
+         *          of the entry.
+         */
+        std::uint64_t m_mask;
+
+        /**
+         * @brief - The index of the current search, wrapping
+         *          around after 256 searches.
+         */
+        unsigned m_generation;
+    };
+
+  }
+}
+
+#endif    /* TRANSPOSITION_TABLE_HH */
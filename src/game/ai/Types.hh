@@ -1,7 +1,17 @@
 #ifndef    TYPES_HH
 # define   TYPES_HH
 
+# include <vector>
+# include <cstdint>
 # include "Coordinates.hh"
+# include "Piece.hh"
+# include "FixedList.hh"
+
+/// @brief - Defines the evaluation of the checkmate position.
+/// This value should be high enough to not be mistaken for
+/// another position but small enough so that we can still be
+/// able to distinguish between faster mates.
+# define CHECKMATE_EVALUATION 32000
 
 namespace chess {
 
@@ -20,12 +30,130 @@ namespace chess {
       // Defines the ending coordinates for the move.
       Coordinates end;
 
+      // The piece performing the move.
+      Piece piece;
+
+      // The piece captured by the move, if any. This is not
+      // at the ending coordinates in case of en passant.
+      Piece captured;
+
+      // The type of the piece a pawn is promoted to, `None`
+      // if the move is not a promotion.
+      Type promotion;
+
       // An information of the weight of this move, which
       // describe how favorable it is for the side playing
       // it.
       int weight;
     };
 
+    /// @brief - A list of moves, large enough to hold all the
+    /// moves available in any position (at most 218 are legal).
+    using MoveList = FixedList<Move, 256u>;
+
+    /// @brief - The budget allowed to a search. The search is
+    /// stopped as soon as one of the limits is reached.
+    struct SearchLimits {
+      // The maximum depth of the search.
+      unsigned depth;
+
+      // The time allowed for the search in milliseconds, or
+      // `0` for no limit.
+      unsigned time;
+
+      // The maximum number of nodes to visit, or `0` for no
+      // limit.
+      std::uint64_t nodes;
+    };
+
+    /// @brief - The selective techniques used to skip parts
+    /// of the tree which are unlikely to change the result of
+    /// the search. Each one can be disabled to measure its
+    /// impact.
+    struct Pruning {
+      // Let the opponent play twice to detect positions which
+      // are good enough to not be searched fully.
+      bool nullMove;
+
+      // Search the moves ordered last with a reduced depth.
+      bool lateMoveReductions;
+
+      // Skip quiet moves close to the leaves when the position
+      // is far below alpha.
+      bool futility;
+
+      // Drop into the quiescence search one ply before the
+      // leaves when the position is far below alpha.
+      bool razoring;
+    };
+
+    /// @brief - Statistics about one complete iteration of the
+    /// search of the main thread.
+    struct IterationStats {
+      // The depth of the iteration.
+      unsigned depth;
+
+      // The number of nodes visited during the iteration.
+      std::uint64_t nodes;
+
+      // The time spent in the iteration in milliseconds.
+      float time;
+
+      // The effective branching factor: the ratio between the
+      // nodes of this iteration and the ones of the previous
+      // iteration, `0` for the first one.
+      float branching;
+    };
+
+    /// @brief - Statistics about the last search of an AI. The
+    /// counters are summed over all the searching threads.
+    struct SearchStats {
+      // The depth of the last complete iteration.
+      unsigned depth;
+
+      // The number of nodes visited, including the ones of the
+      // quiescence search.
+      std::uint64_t nodes;
+
+      // The number of nodes visited by the quiescence search.
+      std::uint64_t quiescence;
+
+      // The duration of the search in milliseconds.
+      float time;
+
+      // The number of nodes visited per second.
+      float nps;
+
+      // The number of nodes of the main search where a move
+      // exceeded beta.
+      std::uint64_t cutoffs;
+
+      // The number of these cutoffs produced by the first move
+      // searched: this measures the quality of the ordering.
+      std::uint64_t firstMoveCutoffs;
+
+      // The number of lookups in the transposition table.
+      std::uint64_t probes;
+
+      // The number of lookups which found the position.
+      std::uint64_t hits;
+
+      // The iterations completed by the main thread.
+      std::vector<IterationStats> iterations;
+    };
+
+    /// @brief - How the opening book is used to pick moves.
+    struct BookSettings {
+      // The number of moves of each side for which the book
+      // is probed, counted from the start of the game.
+      unsigned depth;
+
+      // Between `0`, where the move with the highest weight is
+      // always played, and `1`, where each move is played with
+      // a probability proportional to its weight.
+      float randomness;
+    };
+
   }
 }
 
@@ -6,28 +6,16 @@
 namespace chess {
   namespace bishop {
 
-    CoordinatesSet
+    CoordinatesList
     reachable(const Color& c,
               const Coordinates& p,
               const Board& b) noexcept
     {
-      CoordinatesSet out;
-
-      std::vector<Coordinates> d;
-      // Top right diagonal.
-      d = generate(c, p, 1, 1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Top left diagonal.
-      d = generate(c, p, -1, 1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Bottom left diagonal.
-      d = generate(c, p, -1, -1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Bottom right diagonal.
-      d = generate(c, p, 1, -1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-
-      return out;
+      // The attacks include the first blocking piece
+      // along each line: remove the ones that belong
+      // to our own color.
+      Bitboard attacks = bitboard::bishopAttacks(p.y() * 8 + p.x(), b.occupancy());
+      return toCoordinates(attacks & ~b.occupancy(c));
     }
 
   }
@@ -4,57 +4,13 @@
 
 namespace chess {
 
-  std::vector<Coordinates>
-  generate(const Color& c,
-           const Coordinates& s,
-           int dx,
-           int dy,
-           int length,
-           const Board& b,
-           bool includeSelf,
-           bool stopWhenBlocked) noexcept
-  {
-    std::vector<Coordinates> out;
-
-    int x = s.x();
-    int y = s.y();
-    int count = 0;
-
-    bool xOk = (x >= 0 && x < b.w());
-    bool yOk = (y >= 0 && y < b.h());
-    bool lOk = (length < 0 || count <= length);
-    bool blocked = false;
-
-    while (xOk && yOk && lOk && !blocked) {
-      Coordinates co(x, y);
-
-      // Handle self inclusion.
-      if (x == s.x() && y == s.y()) {
-        if (includeSelf) {
-          out.push_back(co);
-        }
-      }
-
-      if (x != s.x() || y != s.y()) {
-        const Piece& ce = b.at(co);
-        blocked = ce.valid();
-
-        // We still consider the cell if the color
-        // of the piece is different from our own:
-        // in this case a capture is possible.
-        if (!blocked || ce.color() != c) {
-          out.push_back(co);
-        }
-      }
-
-      x += dx;
-      y += dy;
-      ++count;
+  CoordinatesList
+  toCoordinates(Bitboard cells) noexcept {
+    CoordinatesList out;
 
-      xOk = (x >= 0 && x < b.w());
-      yOk = (y >= 0 && y < b.h());
-      lOk = (length < 0 || count <= length);
-      blocked = blocked && stopWhenBlocked;
+    while (cells != 0u) {
+      int id = bitboard::pop(cells);
+      out.push_back(Coordinates(id % 8, id / 8));
     }
 
     return out;
@@ -3,8 +3,8 @@
 
 # include <string>
 # include <memory>
-# include <unordered_set>
 # include "Color.hh"
+# include "FixedList.hh"
 
 namespace chess {
   namespace cells {
@@ -127,7 +127,9 @@ namespace chess {
   using CoordinatesShPtr = std::shared_ptr<Coordinates>;
 
   /// @brief - Convenience define for a list of unique coordinates.
-  using CoordinatesSet = std::unordered_set<Coordinates>;
+  /// The capacity is enough to hold all the cells a single piece
+  /// can reach: a queen reaches at most 27 cells.
+  using CoordinatesList = FixedList<Coordinates, 32u>;
 
   /**
    * @brief - Used to convert the coordinates expressed in raw
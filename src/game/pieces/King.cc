@@ -6,42 +6,22 @@
 namespace chess {
   namespace king {
 
-    CoordinatesSet
+    CoordinatesList
     reachable(const Color& c,
               const Coordinates& p,
               const Board& b) noexcept
     {
-      CoordinatesSet out;
-
-      // Generate a 3x3 square around the initial
-      // position, ignoring invalid values and the
-      // starting position.
-      for (int y = p.y() - 1 ; y <= p.y() + 1 ; ++y) {
-        for (int x = p.x() - 1 ; x <= p.x() + 1 ; ++x) {
-          Coordinates co(x, y);
-          if (!b.validCoordinates(co)) {
-            continue;
-          }
-
-          // Ignore own cell.
-          if (x == p.x() && y == p.y()) {
-            continue;
-          }
-
-          // Ignore cell with a piece of the same color.
-          const Piece& ce = b.at(x, y);
-          if (ce.valid() && ce.color() == c) {
-            continue;
-          }
-
-          out.insert(co);
-        }
-      }
+      // Generate the cells around the initial
+      // position, ignoring the ones occupied by
+      // a piece of the same color.
+      Bitboard attacks = bitboard::kingAttacks(p.y() * 8 + p.x());
+      CoordinatesList out = toCoordinates(attacks & ~b.occupancy(c));
 
       // We also need to check for castling. This
       // can only be an option if the king hasn't
-      // moved yet.
-      if (b.hasMoved(p)) {
+      // moved yet and is not in check.
+      Color o = oppositeColor(c);
+      if (b.hasMoved(p) || b.isSquareAttacked(p, o)) {
         return out;
       }
 
@@ -53,23 +33,22 @@ namespace chess {
         // of the king is reachable by the rook. This
         // will be enough to verify that pieces can
         // move.
-        CoordinatesSet av = r.reachable(co, b);
+        CoordinatesList av = r.reachable(co, b);
         Coordinates dest(p.x() + 1, co.y());
-        if (av.count(dest) > 0) {
-          // We need to check that the king is not in
-          // check at the moment and that none of the
-          // position traversed is a check.
+        if (av.contains(dest)) {
+          // We need to check that none of the position
+          // traversed by the king is attacked.
           dest = Coordinates(b.w() - 2, co.y());
 
           bool valid = true;
           int x = p.x() + 1;
           while (x <= dest.x() && valid) {
-            valid = !b.leadsToCheck(p, Coordinates(x, dest.y()));
+            valid = !b.isSquareAttacked(Coordinates(x, dest.y()), o);
             ++x;
           }
 
           if (valid) {
-            out.insert(dest);
+            out.push_back(dest);
           }
         }
       }
@@ -82,23 +61,22 @@ namespace chess {
         // of the king is reachable by the rook. This
         // will be enough to verify that pieces can
         // move.
-        CoordinatesSet av = r.reachable(co, b);
+        CoordinatesList av = r.reachable(co, b);
         Coordinates dest(p.x() - 1, co.y());
-        if (av.count(dest) > 0) {
-          // We need to check that the king is not in
-          // check at the moment and that none of the
-          // position traversed is a check.
+        if (av.contains(dest)) {
+          // We need to check that none of the position
+          // traversed by the king is attacked.
           dest = Coordinates(2, co.y());
 
           bool valid = true;
           int x = p.x() - 1;
           while (x >= dest.x() && valid) {
-            valid = !b.leadsToCheck(p, Coordinates(x, dest.y()));
+            valid = !b.isSquareAttacked(Coordinates(x, dest.y()), o);
             --x;
           }
 
           if (valid) {
-            out.insert(dest);
+            out.push_back(dest);
           }
         }
       }
@@ -12,7 +12,7 @@ namespace chess {
 
   namespace knight {
 
-    CoordinatesSet
+    CoordinatesList
     reachable(const Color& c,
               const Coordinates& p,
               const Board& b) noexcept;
@@ -6,12 +6,12 @@
 namespace chess {
   namespace pawn {
 
-    CoordinatesSet
+    CoordinatesList
     reachable(const Color& c,
               const Coordinates& p,
               const Board& b) noexcept
     {
-      CoordinatesSet out;
+      CoordinatesList out;
 
       // Pawns can move forward one or two cells, and also
       // diagonally in case there's a piece to capture or
@@ -30,7 +30,7 @@ namespace chess {
       if (p.y() + dy >= 0 && p.y() + dy < b.h()) {
         const Piece& ce = b.at(p.x(), p.y() + dy);
         if (ce.invalid()) {
-          out.insert(Coordinates(p.x(), p.y() + dy));
+          out.push_back(Coordinates(p.x(), p.y() + dy));
           clearAhead = true;
         }
       }
@@ -41,13 +41,13 @@ namespace chess {
       if (c == Color::White && p.y() == 1 && clearAhead) {
         const Piece& ce = b.at(p.x(), p.y() + 2);
         if (ce.invalid()) {
-          out.insert(Coordinates(p.x(), p.y() + 2));
+          out.push_back(Coordinates(p.x(), p.y() + 2));
         }
       }
       if (c == Color::Black && p.y() == 6 && clearAhead) {
         const Piece& ce = b.at(p.x(), p.y() - 2);
         if (ce.invalid()) {
-          out.insert(Coordinates(p.x(), p.y() - 2));
+          out.push_back(Coordinates(p.x(), p.y() - 2));
         }
       }
 
@@ -56,7 +56,7 @@ namespace chess {
       if (ctl.x() >= 0 && ctl.x() < b.w() && ctl.y() >= 0 && ctl.y() < b.h()) {
         const Piece& ce = b.at(ctl);
         if (ce.valid() && ce.color() != c) {
-          out.insert(ctl);
+          out.push_back(ctl);
         }
       }
 
@@ -64,7 +64,7 @@ namespace chess {
       if (ctr.x() >= 0 && ctr.x() < b.w() && ctr.y() >= 0 && ctr.y() < b.h()) {
         const Piece& ce = b.at(ctr);
         if (ce.valid() && ce.color() != c) {
-          out.insert(ctr);
+          out.push_back(ctr);
         }
       }
 
@@ -88,13 +88,10 @@ namespace chess {
             // In this case, use the previous move.
             // Note that this can only happen for black, as we
             // have the guarantee that the last round is valid.
-            if (b.justMoved(eptl)) {
-              // Make sure that the en passant cell is empty.
-              Coordinates ep(p.x() - 1, p.y() + dy);
-              const Piece& epce = b.at(ep);
-              if (epce.invalid()) {
-                out.insert(ep);
-              }
+            // The pawn should also have moved two cells.
+            Coordinates ep(p.x() - 1, p.y() + dy);
+            if (b.justMoved(eptl) && b.enPassant() == bitboard::cell(ep.y() * 8 + ep.x())) {
+              out.push_back(ep);
             }
           }
         }
@@ -105,14 +102,10 @@ namespace chess {
           // Check that the piece is a pawn of opposite color.
           const Piece& ce = b.at(eptr);
           if (ce.pawn() && ce.color() != c) {
-            // Check that the pawn has just moved.
-            if (b.justMoved(eptr)) {
-              // Make sure that the en passant cell is empty.
-              Coordinates ep(p.x() + 1, p.y() + dy);
-              const Piece& epce = b.at(ep);
-              if (epce.invalid()) {
-                out.insert(ep);
-              }
+            // Check that the pawn has just moved two cells.
+            Coordinates ep(p.x() + 1, p.y() + dy);
+            if (b.justMoved(eptr) && b.enPassant() == bitboard::cell(ep.y() * 8 + ep.x())) {
+              out.push_back(ep);
             }
           }
         }
@@ -8,9 +8,13 @@
 # include "Rook.hh"
 # include "Queen.hh"
 # include "King.hh"
+# include <type_traits>
 
 namespace chess {
 
+  static_assert(sizeof(Piece) == 1u, "Piece should fit in a single byte");
+  static_assert(std::is_trivially_copyable<Piece>::value, "Piece should be trivially copyable");
+
   std::string
   pieceToString(const Type& p) noexcept {
     switch (p) {
@@ -54,61 +58,14 @@ namespace chess {
     }
   }
 
-  Piece::Piece() noexcept:
-    utils::CoreObject("chess"),
-
-    m_type(Type::None),
-    m_color(Color::White)
-  {
-    setService("piece");
-  }
-
-  Piece::Piece(const Type& type,
-               const Color& color) noexcept:
-    utils::CoreObject("chess"),
-
-    m_type(type),
-    m_color(color)
-  {
-    setService("piece");
-  }
-
-  Piece
-  Piece::generate(const Type& type,
-                  const Color& color) noexcept
-  {
-    return Piece(type, color);
-  }
-
-  void
-  Piece::reset() noexcept {
-    m_type = Type::None;
-    m_color = Color::White;
-  }
-
-  bool
-  Piece::valid() const noexcept {
-    return m_type != Type::None;
-  }
-
-  bool
-  Piece::invalid() const noexcept {
-    return !valid();
-  }
-
   std::string
   Piece::algebraic() const noexcept {
-    return pieceToAlgebraic(m_type);
-  }
-
-  Color
-  Piece::color() const noexcept {
-    return m_color;
+    return pieceToAlgebraic(type());
   }
 
   std::string
   Piece::name() const noexcept {
-    return pieceToString(m_type);
+    return pieceToString(type());
   }
 
   std::string
@@ -116,56 +73,28 @@ namespace chess {
     return colorToString(color()) + " " + name();
   }
 
-  bool
-  Piece::pawn() const noexcept {
-    return m_type == Type::Pawn;
-  }
-
-  bool
-  Piece::knight() const noexcept {
-    return m_type == Type::Knight;
-  }
-
-  bool
-  Piece::bishop() const noexcept {
-    return m_type == Type::Bishop;
-  }
-
-  bool
-  Piece::rook() const noexcept {
-    return m_type == Type::Rook;
-  }
-
-  bool
-  Piece::queen() const noexcept {
-    return m_type == Type::Queen;
-  }
-
-  bool
-  Piece::king() const noexcept {
-    return m_type == Type::King;
-  }
-
-  CoordinatesSet
+  CoordinatesList
   Piece::reachable(const Coordinates& p,
                    const Board& b) const noexcept
   {
-    switch (m_type) {
+    Color c = color();
+
+    switch (type()) {
       case Type::Pawn:
-        return pawn::reachable(m_color, p, b);
+        return pawn::reachable(c, p, b);
       case Type::Knight:
-        return knight::reachable(m_color, p, b);
+        return knight::reachable(c, p, b);
       case Type::Bishop:
-        return bishop::reachable(m_color, p, b);
+        return bishop::reachable(c, p, b);
       case Type::Rook:
-        return rook::reachable(m_color, p, b);
+        return rook::reachable(c, p, b);
       case Type::Queen:
-        return queen::reachable(m_color, p, b);
+        return queen::reachable(c, p, b);
       case Type::King:
-        return king::reachable(m_color, p, b);
+        return king::reachable(c, p, b);
       case Type::None:
       default:
-        return CoordinatesSet();
+        return CoordinatesList();
     }
   }
 
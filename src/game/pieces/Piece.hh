@@ -1,7 +1,7 @@
 #ifndef    PIECE_HH
 # define   PIECE_HH
 
-# include <core_utils/CoreObject.hh>
+# include <cstdint>
 # include "Color.hh"
 # include "Coordinates.hh"
 
@@ -39,12 +39,18 @@ namespace chess {
   /// in the definition of methods.
   class Board;
 
-  class Piece: public utils::CoreObject {
+  /// @brief - A piece is packed in a single byte holding both
+  /// its type and its color. It is trivially copyable so that
+  /// the board and the moves can be copied without any cost.
+  /// The empty piece is encoded as `0`, which allows to zero
+  /// initialize a board.
+  class Piece {
     public:
 
       /**
        * @brief - Build an invalid piece.
        */
+      constexpr
       Piece() noexcept;
 
       /**
@@ -55,6 +61,7 @@ namespace chess {
        * @return - the generated piece.
        */
       static
+      constexpr
       Piece
       generate(const Type& type = Type::None,
                const Color& color = Color::White) noexcept;
@@ -62,6 +69,7 @@ namespace chess {
       /**
        * @brief - Reset the piece to an invalid piece.
        */
+      constexpr
       void
       reset() noexcept;
 
@@ -70,6 +78,7 @@ namespace chess {
        *          valid piece.
        * @return - `true` if the piece is valid.
        */
+      constexpr
       bool
       valid() const noexcept;
 
@@ -78,6 +87,7 @@ namespace chess {
        *          not valid.
        * @return - `true` if the piece is invalid.
        */
+      constexpr
       bool
       invalid() const noexcept;
 
@@ -88,10 +98,19 @@ namespace chess {
       std::string
       algebraic() const noexcept;
 
+      /**
+       * @brief - Return the type of this piece.
+       * @return - the type of this piece.
+       */
+      constexpr
+      Type
+      type() const noexcept;
+
       /**
        * @brief - Return the color of this piece.
        * @return - the color of this piece.
        */
+      constexpr
       Color
       color() const noexcept;
 
@@ -113,36 +132,42 @@ namespace chess {
       /**
        * @brief - Whether or not this piece is a pawn.
        */
+      constexpr
       bool
       pawn() const noexcept;
 
       /**
        * @brief - Whether or not this piece is a knight.
        */
+      constexpr
       bool
       knight() const noexcept;
 
       /**
        * @brief - Whether or not this piece is a bishop.
        */
+      constexpr
       bool
       bishop() const noexcept;
 
       /**
        * @brief - Whether or not this piece is a rook.
        */
+      constexpr
       bool
       rook() const noexcept;
 
       /**
        * @brief - Whether or not this piece is a queen.
        */
+      constexpr
       bool
       queen() const noexcept;
 
       /**
        * @brief - Whether or not this piece is a king.
        */
+      constexpr
       bool
       king() const noexcept;
 
@@ -155,11 +180,35 @@ namespace chess {
        * @return - the list of coordinates reachable by this
        *           piece.
        */
-      CoordinatesSet
+      CoordinatesList
       reachable(const Coordinates& p,
                 const Board& b) const noexcept;
 
-    protected:
+      /**
+       * @brief - Returns the raw encoding of the piece. The empty
+       *          piece is `0`, the lowest three bits hold the type
+       *          of the piece (shifted by one) and the fourth bit
+       *          is set for black pieces.
+       * @return - the code of the piece.
+       */
+      constexpr
+      std::uint8_t
+      code() const noexcept;
+
+      /**
+       * @brief - Whether two pieces have the same type and color.
+       * @param rhs - the other piece.
+       * @return - `true` if both pieces are identical.
+       */
+      constexpr
+      bool
+      operator==(const Piece& rhs) const noexcept;
+
+      constexpr
+      bool
+      operator!=(const Piece& rhs) const noexcept;
+
+    private:
 
       /**
        * @brief - Create a new piece with the specified type
@@ -167,22 +216,21 @@ namespace chess {
        * @param type - the type of the piece.
        * @param color - the color of the piece.
        */
+      constexpr
       Piece(const Type& type,
             const Color& color) noexcept;
 
     private:
 
       /**
-       * @brief - The type of the piece.
+       * @brief - The encoding of the type and color of the piece
+       *          as described in the `code` method.
        */
-      Type m_type;
-
-      /**
-       * @brief - The color of this piece.
-       */
-      Color m_color;
+      std::uint8_t m_code;
   };
 
 }
 
+# include "Piece.hxx"
+
 #endif    /* PIECE_HH */
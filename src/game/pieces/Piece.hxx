@@ -0,0 +1,122 @@
+#ifndef    PIECE_HXX
+# define   PIECE_HXX
+
+# include "Piece.hh"
+
+namespace chess {
+
+  constexpr
+  Piece::Piece() noexcept:
+    m_code(0u)
+  {}
+
+  constexpr
+  Piece::Piece(const Type& type,
+               const Color& color) noexcept:
+    m_code(0u)
+  {
+    if (type != Type::None) {
+      m_code = static_cast<std::uint8_t>(static_cast<unsigned>(type) + 1u);
+      m_code |= (color == Color::Black ? 8u : 0u);
+    }
+  }
+
+  constexpr
+  Piece
+  Piece::generate(const Type& type,
+                  const Color& color) noexcept
+  {
+    return Piece(type, color);
+  }
+
+  constexpr
+  void
+  Piece::reset() noexcept {
+    m_code = 0u;
+  }
+
+  constexpr
+  bool
+  Piece::valid() const noexcept {
+    return m_code != 0u;
+  }
+
+  constexpr
+  bool
+  Piece::invalid() const noexcept {
+    return !valid();
+  }
+
+  constexpr
+  Type
+  Piece::type() const noexcept {
+    if (invalid()) {
+      return Type::None;
+    }
+
+    return static_cast<Type>((m_code & 7u) - 1u);
+  }
+
+  constexpr
+  Color
+  Piece::color() const noexcept {
+    return (m_code & 8u) != 0u ? Color::Black : Color::White;
+  }
+
+  constexpr
+  bool
+  Piece::pawn() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::Pawn) + 1u;
+  }
+
+  constexpr
+  bool
+  Piece::knight() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::Knight) + 1u;
+  }
+
+  constexpr
+  bool
+  Piece::bishop() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::Bishop) + 1u;
+  }
+
+  constexpr
+  bool
+  Piece::rook() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::Rook) + 1u;
+  }
+
+  constexpr
+  bool
+  Piece::queen() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::Queen) + 1u;
+  }
+
+  constexpr
+  bool
+  Piece::king() const noexcept {
+    return (m_code & 7u) == static_cast<unsigned>(Type::King) + 1u;
+  }
+
+  constexpr
+  std::uint8_t
+  Piece::code() const noexcept {
+    return m_code;
+  }
+
+  constexpr
+  bool
+  Piece::operator==(const Piece& rhs) const noexcept {
+    return m_code == rhs.m_code;
+  }
+
+  constexpr
+  bool
+  Piece::operator!=(const Piece& rhs) const noexcept {
+    return !operator==(rhs);
+  }
+
+}
+
+#endif    /* PIECE_HXX */
@@ -6,28 +6,16 @@
 namespace chess {
   namespace rook {
 
-    CoordinatesSet
+    CoordinatesList
     reachable(const Color& c,
               const Coordinates& p,
               const Board& b) noexcept
     {
-      CoordinatesSet out;
-
-      std::vector<Coordinates> d;
-      // Positive horizontal.
-      d = generate(c, p, 1, 0, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Negative horizontal.
-      d = generate(c, p, -1, 0, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Positive vertical.
-      d = generate(c, p, 0, 1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-      // Negative vertical.
-      d = generate(c, p, 0, -1, -1, b, false, true);
-      out.insert(d.begin(), d.end());
-
-      return out;
+      // The attacks include the first blocking piece
+      // along each line: remove the ones that belong
+      // to our own color.
+      Bitboard attacks = bitboard::rookAttacks(p.y() * 8 + p.x(), b.occupancy());
+      return toCoordinates(attacks & ~b.occupancy(c));
     }
 
   }
@@ -0,0 +1,216 @@
+/**
+ * @brief - Measure the time needed by the minimax AI to reach a
+ *          fixed depth on a set of positions with an increasing
+ *          number of threads. This allows to check how the
+ *          parallel search scales with the number of cores.
+ *
+ *          Usage:
+ *            chess_bench [-d depth] [-t threads] [-m hash] [-f fen]
+ *              searches each position (or the input position)
+ *              to the input depth with 1, 2, 4, ... threads up
+ *              to the input count and reports the speedup of the
+ *              time to depth compared to a single thread.
+ *
+ *          The processor time used by the main searcher is also
+ *          reported: when there are more threads than cores, it
+ *          estimates the time to depth the search would take
+ *          with one core per thread, as the threads then share
+ *          the cores evenly.
+ */
+
+# include <chrono>
+# include <thread>
+# include <algorithm>
+# include <vector>
+# include <ctime>
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "ChessGame.hh"
+# include "MinimaxAI.hh"
+
+/// @brief - The default depth of the search.
+# define DEFAULT_DEPTH 9u
+
+/// @brief - The default maximum number of threads.
+# define DEFAULT_THREADS 8u
+
+/// @brief - The default size of the transposition table in
+/// megabytes.
+# define DEFAULT_HASH_MB 64u
+
+namespace {
+
+  /// @brief - The positions searched by default: a mix of
+  /// opening, middlegame and endgame positions.
+  const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+  };
+
+  /// @brief - The time needed to reach the depth on all the
+  /// positions.
+  struct Timing {
+    // The elapsed time in milliseconds.
+    double wall;
+
+    // The processor time used by the main searcher in
+    // milliseconds.
+    double main;
+  };
+
+  /**
+   * @brief - Returns the processor time used by the calling
+   *          thread.
+   * @return - the time in milliseconds.
+   */
+  double
+  threadTime() noexcept {
+    timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return 1000.0 * ts.tv_sec + ts.tv_nsec / 1000000.0;
+  }
+
+  /**
+   * @brief - Search all the positions with the input number
+   *          of threads and returns the time spent.
+   * @param logger - the logger to use.
+   * @param fens - the positions to search.
+   * @param depth - the depth of the search.
+   * @param threads - the number of threads.
+   * @param hash - the size of the table in megabytes.
+   * @return - the total time spent.
+   */
+  Timing
+  run(utils::log::PrefixedLogger& logger,
+      const std::vector<std::string>& fens,
+      unsigned depth,
+      unsigned threads,
+      unsigned hash)
+  {
+    Timing total{0.0, 0.0};
+
+    for (unsigned id = 0u ; id < fens.size() ; ++id) {
+      chess::ChessGame game;
+      game.fromFEN(fens[id]);
+
+      // Use a new AI for each position so that the table does
+      // not contain results from a previous search.
+      chess::MinimaxAI ai(game.getPlayer(), chess::ai::SearchLimits{depth, 0u, 0u}, hash, threads);
+
+      // The main searcher runs on the calling thread.
+      double busy = threadTime();
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      ai.play(game);
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+      total.wall += elapsed.count();
+      total.main += threadTime() - busy;
+    }
+
+    logger.notice(
+      std::to_string(threads) + " thread(s): depth " + std::to_string(depth) + " reached in " +
+      std::to_string(static_cast<int>(total.wall)) + "ms (main searcher busy for " +
+      std::to_string(static_cast<int>(total.main)) + "ms)"
+    );
+
+    return total;
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  // Create the logger. The logs of the AI are not displayed
+  // as they would hide the results.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::NOTICE);
+  utils::log::PrefixedLogger logger("chess", "bench");
+  utils::log::Locator::provide(&raw);
+
+  bool success = true;
+
+  try {
+    std::vector<std::string> fens;
+    unsigned depth = DEFAULT_DEPTH;
+    unsigned threads = DEFAULT_THREADS;
+    unsigned hash = DEFAULT_HASH_MB;
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg = argv[id];
+
+      if (arg == "-d" && id + 1 < argc) {
+        depth = std::stoul(argv[++id]);
+      }
+      else if (arg == "-t" && id + 1 < argc) {
+        threads = std::stoul(argv[++id]);
+      }
+      else if (arg == "-m" && id + 1 < argc) {
+        hash = std::stoul(argv[++id]);
+      }
+      else if (arg == "-f" && id + 1 < argc) {
+        fens.push_back(argv[++id]);
+      }
+      else {
+        logger.error("Unknown argument \"" + arg + "\"");
+        logger.notice("Usage: " + std::string(argv[0]) + " [-d depth] [-t threads] [-m hash] [-f fen]");
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (fens.empty()) {
+      for (unsigned id = 0u ; id < sizeof(POSITIONS) / sizeof(POSITIONS[0]) ; ++id) {
+        fens.push_back(POSITIONS[id]);
+      }
+    }
+
+    unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    if (threads > cores) {
+      logger.notice(
+        "Only " + std::to_string(cores) + " core(s) available: the speedups beyond are estimated " +
+        "from the time used by the main searcher"
+      );
+    }
+
+    Timing reference{0.0, 0.0};
+    for (unsigned count = 1u ; count <= threads ; count *= 2u) {
+      Timing elapsed = run(logger, fens, depth, count, hash);
+
+      if (count == 1u) {
+        reference = elapsed;
+        continue;
+      }
+
+      double speedup = (elapsed.wall > 0.0 ? reference.wall / elapsed.wall : 0.0);
+      std::string kind = "measured";
+
+      if (count > cores) {
+        speedup = (elapsed.main > 0.0 ? reference.main / elapsed.main : 0.0);
+        kind = "estimated";
+      }
+
+      logger.notice(
+        "Speedup with " + std::to_string(count) + " thread(s): " + std::to_string(speedup) + " (" + kind + ")"
+      );
+    }
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while running benchmark", e.what());
+    success = false;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while running benchmark", e.what());
+    success = false;
+  }
+  catch (...) {
+    logger.error("Unexpected error while running benchmark");
+    success = false;
+  }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
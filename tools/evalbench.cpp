@@ -0,0 +1,476 @@
+/**
+ * @brief - Measure the throughput of the evaluators used by the
+ *          search in evaluations per second. Random games are
+ *          played from a set of positions, making and unmaking
+ *          moves so that the evaluators update their state like
+ *          they do during a search, and every position reached
+ *          is evaluated.
+ *
+ *          The computation of the material and piece-square
+ *          scores of a whole board is also measured, comparing
+ *          the vectorized scan of the cells with the scalar one
+ *          and with a loop over the cells decoding each piece. The
+ *          three methods read the same codes, streamed from a
+ *          buffer holding as many distinct positions as boards to
+ *          scan, so that none of them runs from the cache.
+ *
+ *          Usage:
+ *            chess_evalbench [-w weights] [-n evaluations]
+ *              measures the piece-square evaluation and the neural
+ *              network with the input weights, both incrementally
+ *              and by computing the first layer from scratch for
+ *              each position. Without weights a network with random
+ *              weights is used: it is only meaningful for speed.
+ */
+
+# include <chrono>
+# include <random>
+# include <fstream>
+# include <cstdio>
+# include <vector>
+# include <unordered_set>
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "Board.hh"
+# include "Evaluation.hh"
+# include "MoveGeneration.hh"
+# include "Evaluator.hh"
+# include "NetworkEvaluator.hh"
+# include "Kernels.hh"
+
+/// @brief - The default number of evaluations.
+# define DEFAULT_EVALUATIONS 2000000u
+
+/// @brief - The maximum number of moves of a random game
+/// before the moves are unmade.
+# define MAX_PLIES 24u
+
+/// @brief - The file where the random network is written.
+# define RANDOM_NETWORK_FILE "chess_random.nnue"
+
+/// @brief - The maximum number of moves of the random games
+/// producing the positions on which the scores of the whole
+/// board are computed.
+# define SCAN_PLIES 200u
+
+namespace {
+
+  /// @brief - The positions from which random games start.
+  const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+  };
+
+  /**
+   * @brief - Write a network with random weights to the input
+   *          file, following the format expected by `Network`.
+   * @param file - the path to the file.
+   */
+  void
+  writeRandomNetwork(const std::string& file) {
+    std::ofstream out(file, std::ios::binary);
+    if (!out.good()) {
+      throw utils::CoreException("Failed to write random network", "bench", "chess", "Unable to open \"" + file + "\"");
+    }
+
+    std::mt19937 rng(42u);
+
+    auto write = [&out, &rng](unsigned count, unsigned bytes, int min, int max) {
+      std::uniform_int_distribution<int> dist(min, max);
+
+      for (unsigned id = 0u ; id < count ; ++id) {
+        std::int32_t v = dist(rng);
+        out.write(reinterpret_cast<const char*>(&v), bytes);
+      }
+    };
+
+    out.write(NETWORK_MAGIC, sizeof(NETWORK_MAGIC) - 1u);
+
+    write(NETWORK_HALF_DIMENSIONS, 2u, 0, 64);
+    write(NETWORK_FEATURES * NETWORK_HALF_DIMENSIONS, 2u, -8, 8);
+    write(NETWORK_HIDDEN_DIMENSIONS, 4u, -512, 512);
+    write(NETWORK_HIDDEN_DIMENSIONS * 2u * NETWORK_HALF_DIMENSIONS, 1u, -16, 16);
+    write(NETWORK_HIDDEN_DIMENSIONS, 4u, -512, 512);
+    write(NETWORK_HIDDEN_DIMENSIONS * NETWORK_HIDDEN_DIMENSIONS, 1u, -32, 32);
+    write(1u, 4u, -512, 512);
+    write(NETWORK_HIDDEN_DIMENSIONS, 1u, -64, 64);
+  }
+
+  /**
+   * @brief - Play random games from the reference positions and
+   *          evaluate each position reached.
+   * @param evaluator - the evaluator, or null to only measure
+   *                    the cost of playing the games.
+   * @param count - the number of evaluations.
+   * @param refresh - whether the evaluator is reset before each
+   *                  evaluation rather than updated incrementally.
+   * @param check - if not null, each evaluation is compared to
+   *                the one of this evaluator reset on the position.
+   * @return - the sum of the evaluations, so that they can't be
+   *           optimized away.
+   */
+  std::int64_t
+  run(chess::ai::Evaluator* evaluator,
+      unsigned count,
+      bool refresh,
+      chess::ai::Evaluator* check)
+  {
+    std::mt19937 rng(1u);
+    std::int64_t sum = 0;
+    unsigned done = 0u;
+    unsigned position = 0u;
+
+    while (done < count) {
+      chess::Board b;
+      chess::Color side = chess::Color::White;
+      b.fromFEN(POSITIONS[position % (sizeof(POSITIONS) / sizeof(POSITIONS[0]))], &side);
+      ++position;
+
+      if (evaluator != nullptr) {
+        evaluator->reset(b);
+      }
+
+      std::array<chess::UndoRecord, MAX_PLIES> undo;
+      unsigned plies = 0u;
+      while (plies < MAX_PLIES && done < count) {
+        chess::ai::MoveList moves = chess::ai::generate(side, b);
+        if (moves.empty()) {
+          break;
+        }
+
+        const chess::ai::Move& m = moves[rng() % moves.size()];
+        b.makeMove(m.start, m.end, m.promotion, undo[plies]);
+        side = chess::oppositeColor(side);
+        ++plies;
+
+        ++done;
+        if (evaluator == nullptr) {
+          continue;
+        }
+
+        if (refresh) {
+          evaluator->reset(b);
+        }
+        else {
+          evaluator->push(b);
+        }
+
+        int eval = evaluator->evaluate(side, b);
+        sum += eval;
+
+        if (check != nullptr) {
+          check->reset(b);
+          int expected = check->evaluate(side, b);
+
+          if (eval != expected) {
+            throw utils::CoreException(
+              "Incremental evaluation " + std::to_string(eval) + " differs from " + std::to_string(expected),
+              "bench",
+              "chess",
+              "Inconsistent evaluator"
+            );
+          }
+        }
+      }
+
+      for (unsigned id = plies ; id > 0u ; --id) {
+        b.unmakeMove(undo[id - 1u]);
+        if (evaluator != nullptr && !refresh) {
+          evaluator->pop();
+        }
+      }
+    }
+
+    return sum;
+  }
+
+  /**
+   * @brief - Computes the scores of a board by looping over
+   *          its cells, like the evaluation did before it was
+   *          maintained by the board.
+   * @param b - the board.
+   * @return - the scores of the board.
+   */
+  chess::evaluation::Totals
+  scanBoard(const chess::Board& b) noexcept {
+    chess::evaluation::Totals t{0, 0, 0};
+
+    for (int y = 0 ; y < b.h() ; ++y) {
+      for (int x = 0 ; x < b.w() ; ++x) {
+        const chess::Piece& p = b.at(x, y);
+        if (p.invalid()) {
+          continue;
+        }
+
+        int sign = (p.color() == chess::Color::White ? 1 : -1);
+        int id = y * b.w() + x;
+
+        t.middlegame += sign * chess::evaluation::middlegame(p.color(), p.type(), id);
+        t.endgame += sign * chess::evaluation::endgame(p.color(), p.type(), id);
+        t.phase += chess::evaluation::phase(p.type());
+      }
+    }
+
+    return t;
+  }
+
+  /**
+   * @brief - Computes the scores of a board with the same loop
+   *          as `scanBoard`, but reading the codes of the pieces
+   *          like the scans so that the methods are timed on the
+   *          same data.
+   * @param codes - the codes of the pieces, indexed by cell.
+   * @return - the scores of the board.
+   */
+  chess::evaluation::Totals
+  scanCells(const std::uint8_t* codes) noexcept {
+    chess::evaluation::Totals t{0, 0, 0};
+
+    for (int id = 0 ; id < 64 ; ++id) {
+      unsigned code = codes[id];
+      if (code == 0u) {
+        continue;
+      }
+
+      chess::Color c = ((code & 8u) != 0u ? chess::Color::Black : chess::Color::White);
+      chess::Type type = static_cast<chess::Type>((code & 7u) - 1u);
+      int sign = (c == chess::Color::White ? 1 : -1);
+
+      t.middlegame += sign * chess::evaluation::middlegame(c, type, id);
+      t.endgame += sign * chess::evaluation::endgame(c, type, id);
+      t.phase += chess::evaluation::phase(type);
+    }
+
+    return t;
+  }
+
+  /**
+   * @brief - Generate distinct random positions by playing random
+   *          games from the reference positions, and keep the code
+   *          of the piece on each cell of every position reached
+   *          for the first time. Each position is used to check
+   *          that the scans agree with the loop over the board.
+   * @param count - the number of positions.
+   * @return - the codes of the positions, 64 per position.
+   */
+  std::vector<std::uint8_t>
+  generatePositions(unsigned count) {
+    std::mt19937 rng(2u);
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(count) * 64u);
+    std::unordered_set<chess::Key> seen;
+
+    auto same = [](const chess::evaluation::Totals& lhs, const chess::evaluation::Totals& rhs) {
+      return lhs.middlegame == rhs.middlegame && lhs.endgame == rhs.endgame && lhs.phase == rhs.phase;
+    };
+
+    unsigned done = 0u;
+    unsigned game = 0u;
+
+    while (done < count) {
+      chess::Board b;
+      chess::Color side = chess::Color::White;
+      b.fromFEN(POSITIONS[game % (sizeof(POSITIONS) / sizeof(POSITIONS[0]))], &side);
+      ++game;
+
+      for (unsigned ply = 0u ; ply < SCAN_PLIES && done < count ; ++ply) {
+        chess::ai::MoveList moves = chess::ai::generate(side, b);
+        if (moves.empty()) {
+          break;
+        }
+
+        const chess::ai::Move& m = moves[rng() % moves.size()];
+        b.move(m.start, m.end, m.promotion != chess::Type::None, m.promotion);
+        side = chess::oppositeColor(side);
+
+        if (!seen.insert(b.key()).second) {
+          continue;
+        }
+
+        std::uint8_t* codes = out.data() + static_cast<std::size_t>(done) * 64u;
+        for (int cell = 0 ; cell < 64 ; ++cell) {
+          codes[cell] = b.at(cell % 8, cell / 8).code();
+        }
+
+        chess::evaluation::Totals expected = scanBoard(b);
+        bool valid =
+          same(scanCells(codes), expected) &&
+          same(chess::evaluation::scanScalar(codes), expected) &&
+          same(chess::evaluation::scan(codes), expected);
+
+        if (!valid) {
+          throw utils::CoreException(
+            "Scan of " + b.toFEN(side) + " differs from the loop over the board",
+            "bench",
+            "chess",
+            "Inconsistent scan"
+          );
+        }
+
+        ++done;
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - Measure the time needed to compute the scores of
+   *          a whole board with each method and log it. Each
+   *          board is scanned once, in the order of generation.
+   * @param logger - the logger to use.
+   * @param count - the number of boards to scan.
+   */
+  void
+  measureScan(utils::log::PrefixedLogger& logger, unsigned count) {
+    std::vector<std::uint8_t> codes = generatePositions(count);
+
+    logger.info(
+      "Scans of the board are consistent on " + std::to_string(count) + " distinct position(s) (" +
+      std::to_string(codes.size() / (1024u * 1024u)) + "MB of codes)"
+    );
+
+    auto time = [&logger, &codes, count](const std::string& name, auto scan) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      std::int64_t sum = 0;
+      for (unsigned id = 0u ; id < count ; ++id) {
+        chess::evaluation::Totals t = scan(codes.data() + static_cast<std::size_t>(id) * 64u);
+        sum += chess::evaluation::taper(t.middlegame, t.endgame, t.phase);
+      }
+
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      double rate = (elapsed.count() > 0.0 ? count / elapsed.count() : 0.0);
+
+      logger.notice(
+        name + ": " + std::to_string(count) + " board(s) in " +
+        std::to_string(static_cast<int>(elapsed.count() * 1000.0)) + "ms (" +
+        std::to_string(static_cast<std::uint64_t>(rate)) + " boards/s, checksum " + std::to_string(sum) + ")"
+      );
+    };
+
+    time("Scan (cell loop)", [](const std::uint8_t* c) { return scanCells(c); });
+    time("Scan (scalar)", [](const std::uint8_t* c) { return chess::evaluation::scanScalar(c); });
+    time("Scan (vectorized)", [](const std::uint8_t* c) { return chess::evaluation::scan(c); });
+  }
+
+  /**
+   * @brief - Measure the throughput of an evaluator and log it.
+   *          The time spent to play the games is measured first
+   *          and excluded from the throughput.
+   * @param logger - the logger to use.
+   * @param name - the name of the evaluator.
+   * @param evaluator - the evaluator.
+   * @param count - the number of evaluations.
+   * @param refresh - whether the evaluator is reset before each
+   *                  evaluation.
+   */
+  void
+  measure(utils::log::PrefixedLogger& logger,
+          const std::string& name,
+          chess::ai::Evaluator& evaluator,
+          unsigned count,
+          bool refresh)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    run(nullptr, count, refresh, nullptr);
+    std::chrono::duration<double> games = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::int64_t sum = run(&evaluator, count, refresh, nullptr);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start - games;
+
+    // The evaluation can be faster than the noise of the time
+    // needed to play the games.
+    if (elapsed.count() < 0.0) {
+      elapsed = std::chrono::duration<double>::zero();
+    }
+
+    double rate = (elapsed.count() > 0.0 ? count / elapsed.count() : 0.0);
+
+    logger.notice(
+      name + ": " + std::to_string(count) + " evaluation(s) in " +
+      std::to_string(static_cast<int>(elapsed.count() * 1000.0)) + "ms (" +
+      std::to_string(static_cast<std::uint64_t>(rate)) + " evals/s, checksum " + std::to_string(sum) + ")"
+    );
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("chess", "evalbench");
+  utils::log::Locator::provide(&raw);
+
+  bool success = true;
+
+  try {
+    std::string weights;
+    unsigned count = DEFAULT_EVALUATIONS;
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg = argv[id];
+
+      if (arg == "-w" && id + 1 < argc) {
+        weights = argv[++id];
+      }
+      else if (arg == "-n" && id + 1 < argc) {
+        count = std::stoul(argv[++id]);
+      }
+      else {
+        logger.error("Unknown argument \"" + arg + "\"");
+        logger.notice("Usage: " + std::string(argv[0]) + " [-w weights] [-n evaluations]");
+        return EXIT_FAILURE;
+      }
+    }
+
+    bool random = weights.empty();
+    if (random) {
+      weights = RANDOM_NETWORK_FILE;
+      logger.info("Writing network with random weights to \"" + weights + "\"");
+      writeRandomNetwork(weights);
+    }
+
+    chess::ai::NetworkShPtr network = std::make_shared<chess::ai::Network>(weights);
+
+    if (random) {
+      std::remove(weights.c_str());
+    }
+
+    logger.notice("Using " + std::string(chess::ai::kernels::instructions()) + " kernels");
+
+    // Make sure that the incremental updates produce the same
+    // result as a computation from scratch.
+    chess::ai::NetworkEvaluator incremental(network);
+    chess::ai::NetworkEvaluator reference(network);
+    run(&incremental, 20000u, false, &reference);
+    logger.info("Incremental updates of the network are consistent");
+
+    chess::ai::PieceSquareEvaluator pst;
+    measure(logger, "Piece-square", pst, count, false);
+    measure(logger, "Network (incremental)", incremental, count, false);
+    measure(logger, "Network (refresh)", incremental, count / 4u, true);
+
+    measureScan(logger, count);
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while running benchmark", e.what());
+    success = false;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while running benchmark", e.what());
+    success = false;
+  }
+  catch (...) {
+    logger.error("Unexpected error while running benchmark");
+    success = false;
+  }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
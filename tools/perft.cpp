@@ -0,0 +1,282 @@
+
+/**
+ * @brief - Count the leaves of the tree of legal moves up to a
+ *          certain depth (perft) from a position. This allows
+ *          to check the correctness of the move generation by
+ *          comparing with well-known counts, and to measure its
+ *          speed in nodes per second.
+ *
+ *          Usage:
+ *            chess_perft
+ *              runs all the reference positions at their default
+ *              depth and checks the results.
+ *            chess_perft [-d depth] [-f fen] [--divide]
+ *              runs perft from the start position (or the input
+ *              position) to the input depth. The divide option
+ *              prints the count of each move at the root.
+ */
+
+# include <chrono>
+# include <cctype>
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "Board.hh"
+# include "MoveGeneration.hh"
+
+/// @brief - The default depth when running perft from a
+/// single position.
+# define DEFAULT_DEPTH 5u
+
+/// @brief - The maximum depth with a reference count.
+# define REFERENCE_DEPTH 6u
+
+/// @brief - The FEN describing the start position.
+# define START_POSITION "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+
+namespace {
+
+  /// @brief - A position with well-known perft counts. See:
+  /// https://www.chessprogramming.org/Perft_Results
+  struct Reference {
+    // The name of the position.
+    const char* name;
+
+    // The FEN describing the position.
+    const char* fen;
+
+    // The depth used when running the reference positions.
+    unsigned depth;
+
+    // The number of leaves for each depth starting at 1.
+    std::uint64_t nodes[REFERENCE_DEPTH];
+  };
+
+  const Reference REFERENCES[] = {
+    {
+      "start position",
+      START_POSITION,
+      5u,
+      {20u, 400u, 8902u, 197281u, 4865609u, 119060324u}
+    },
+    {
+      "kiwipete",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      4u,
+      {48u, 2039u, 97862u, 4085603u, 193690690u, 8031647685u}
+    },
+    {
+      "position 3",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      6u,
+      {14u, 191u, 2812u, 43238u, 674624u, 11030083u}
+    },
+    {
+      "position 4",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      5u,
+      {6u, 264u, 9467u, 422333u, 15833292u, 706045033u}
+    },
+    {
+      "position 5",
+      "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      4u,
+      {44u, 1486u, 62379u, 2103487u, 89941194u, 0u}
+    },
+    {
+      "position 6",
+      "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+      4u,
+      {46u, 2079u, 89890u, 3894594u, 164075551u, 6923051137u}
+    }
+  };
+
+  std::string
+  moveToString(const chess::ai::Move& m) {
+    std::string out = chess::cells::toString(m.start.asValue());
+    out += chess::cells::toString(m.end.asValue());
+
+    if (m.promotion != chess::Type::None) {
+      out += static_cast<char>(std::tolower(chess::pieceToAlgebraic(m.promotion)[0]));
+    }
+
+    return out;
+  }
+
+  std::uint64_t
+  perft(chess::Board& b, const chess::Color& side, unsigned depth) {
+    if (depth == 0u) {
+      return 1u;
+    }
+
+    chess::ai::MoveList moves = chess::ai::generate(side, b);
+
+    // The moves are legal so we can count them directly at
+    // the last level.
+    if (depth == 1u) {
+      return moves.size();
+    }
+
+    std::uint64_t nodes = 0u;
+    chess::Color o = chess::oppositeColor(side);
+
+    chess::UndoRecord r;
+    for (unsigned id = 0u ; id < moves.size() ; ++id) {
+      b.makeMove(moves[id].start, moves[id].end, moves[id].promotion, r);
+      nodes += perft(b, o, depth - 1u);
+      b.unmakeMove(r);
+    }
+
+    return nodes;
+  }
+
+  /**
+   * @brief - Run perft from the input position and log the
+   *          results.
+   * @param logger - the logger to use.
+   * @param fen - the position to start from.
+   * @param depth - the depth of the perft.
+   * @param divide - whether to display the count of each move.
+   * @return - the number of leaves.
+   */
+  std::uint64_t
+  run(utils::log::PrefixedLogger& logger,
+      const std::string& fen,
+      unsigned depth,
+      bool divide)
+  {
+    chess::Board b;
+    chess::Color side = chess::Color::White;
+    b.fromFEN(fen, &side);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::uint64_t nodes = 0u;
+
+    if (!divide || depth == 0u) {
+      nodes = perft(b, side, depth);
+    }
+    else {
+      chess::ai::MoveList moves = chess::ai::generate(side, b);
+
+      chess::UndoRecord r;
+      for (unsigned id = 0u ; id < moves.size() ; ++id) {
+        b.makeMove(moves[id].start, moves[id].end, moves[id].promotion, r);
+        std::uint64_t n = perft(b, chess::oppositeColor(side), depth - 1u);
+        b.unmakeMove(r);
+
+        logger.notice(moveToString(moves[id]) + ": " + std::to_string(n));
+        nodes += n;
+      }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double nps = (elapsed.count() > 0.0 ? nodes / elapsed.count() : 0.0);
+
+    logger.notice(
+      "Depth " + std::to_string(depth) + ": " + std::to_string(nodes) + " node(s) in " +
+      std::to_string(static_cast<int>(elapsed.count() * 1000.0)) + "ms (" +
+      std::to_string(static_cast<std::uint64_t>(nps)) + " nps)"
+    );
+
+    return nodes;
+  }
+
+  /**
+   * @brief - Compare the number of nodes with the reference count
+   *          for the position if any.
+   * @return - `false` if the count is known and does not match.
+   */
+  bool
+  check(utils::log::PrefixedLogger& logger,
+        const std::string& fen,
+        unsigned depth,
+        std::uint64_t nodes)
+  {
+    for (unsigned id = 0u ; id < sizeof(REFERENCES) / sizeof(REFERENCES[0]) ; ++id) {
+      const Reference& r = REFERENCES[id];
+      if (fen != r.fen || depth == 0u || depth > REFERENCE_DEPTH || r.nodes[depth - 1u] == 0u) {
+        continue;
+      }
+
+      if (r.nodes[depth - 1u] != nodes) {
+        logger.error(
+          "Perft mismatch for " + std::string(r.name),
+          "Expected " + std::to_string(r.nodes[depth - 1u]) + ", got " + std::to_string(nodes)
+        );
+
+        return false;
+      }
+
+      logger.notice("Perft matches reference for " + std::string(r.name));
+    }
+
+    return true;
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("chess", "perft");
+  utils::log::Locator::provide(&raw);
+
+  bool success = true;
+
+  try {
+    std::string fen = START_POSITION;
+    unsigned depth = DEFAULT_DEPTH;
+    bool divide = false;
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg = argv[id];
+
+      if (arg == "--divide") {
+        divide = true;
+      }
+      else if (arg == "-d" && id + 1 < argc) {
+        depth = std::stoul(argv[++id]);
+      }
+      else if (arg == "-f" && id + 1 < argc) {
+        fen = argv[++id];
+      }
+      else {
+        logger.error("Unknown argument \"" + arg + "\"");
+        logger.notice("Usage: " + std::string(argv[0]) + " [-d depth] [-f fen] [--divide]");
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (argc > 1) {
+      std::uint64_t nodes = run(logger, fen, depth, divide);
+      success = check(logger, fen, depth, nodes);
+    }
+    else {
+      // Run all the reference positions.
+      for (unsigned id = 0u ; id < sizeof(REFERENCES) / sizeof(REFERENCES[0]) ; ++id) {
+        const Reference& r = REFERENCES[id];
+        logger.notice("Running " + std::string(r.name) + " (" + r.fen + ")");
+
+        std::uint64_t nodes = run(logger, r.fen, r.depth, false);
+        success = check(logger, r.fen, r.depth, nodes) && success;
+      }
+    }
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while running perft", e.what());
+    success = false;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while running perft", e.what());
+    success = false;
+  }
+  catch (...) {
+    logger.error("Unexpected error while running perft");
+    success = false;
+  }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,499 @@
+/**
+ * @brief - Generate the tablebases used by the AI to play the
+ *          endgames with few pieces perfectly. Each table holds
+ *          the distance to mate of all the positions of a given
+ *          material and is computed by retrograde analysis with
+ *          the move rules of the board: starting from the mates,
+ *          the positions winning in one ply are found, then the
+ *          ones losing in two plies and so on until no position
+ *          can be solved anymore. The remaining ones are draws.
+ *          Captures and promotions lead to tables generated
+ *          before the current one.
+ *
+ *          Usage:
+ *            chess_tbgen [-o folder] [-t threads] [-e endgame] [-f]
+ *              generates the tables of all the endgames with up
+ *              to four pieces (or only the input one, such as
+ *              `KRvK`) in the output folder. Existing tables are
+ *              kept unless the force option is used.
+ */
+
+# include <chrono>
+# include <cstdlib>
+# include <thread>
+# include <atomic>
+# include <fstream>
+# include <filesystem>
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "Board.hh"
+# include "MoveGeneration.hh"
+# include "Tablebase.hh"
+
+/// @brief - The folder where the tables are written by default.
+# define DEFAULT_DIRECTORY "data/tablebases"
+
+/// @brief - The number of positions handled by a thread at a
+/// time when processing a table.
+# define CHUNK_SIZE 4096u
+
+namespace {
+
+  /// @brief - The entries of the table being generated. They are
+  /// accessed without ordering by all the threads: a pass only
+  /// reads entries solved by previous passes, and those written
+  /// by the current pass are ignored.
+  using Entries = std::unique_ptr<std::atomic<std::uint8_t>[]>;
+
+  /**
+   * @brief - Apply the input function to all the positions of a
+   *          table, using several threads each with its board.
+   * @param threads - the number of threads.
+   * @param size - the number of positions.
+   * @param process - the function called with the board of the
+   *                  thread and the index of a position.
+   */
+  template <typename Function>
+  void
+  parallel(unsigned threads, std::size_t size, Function process) {
+    std::atomic<std::size_t> next(0u);
+
+    auto worker = [&next, size, &process]() {
+      chess::Board b;
+
+      std::size_t start = next.fetch_add(CHUNK_SIZE);
+      while (start < size) {
+        std::size_t end = std::min<std::size_t>(start + CHUNK_SIZE, size);
+        for (std::size_t id = start ; id < end ; ++id) {
+          process(b, id);
+        }
+
+        start = next.fetch_add(CHUNK_SIZE);
+      }
+    };
+
+    std::vector<std::thread> helpers;
+    for (unsigned id = 1u ; id < threads ; ++id) {
+      helpers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (unsigned id = 0u ; id < helpers.size() ; ++id) {
+      helpers[id].join();
+    }
+  }
+
+  bool
+  lookup(const chess::ai::Endgame& endgame,
+         const Entries& entries,
+         const chess::ai::Tablebase& tables,
+         const chess::Board& b,
+         const chess::Color& side,
+         const chess::ai::Move& m,
+         chess::ai::TablebaseResult& result,
+         std::atomic<bool>& missing);
+
+  /**
+   * @brief - Compute the value of a position from the values of
+   *          the positions reached by each of its moves, for the
+   *          positions which can't be read from the table being
+   *          generated. The value is only known once it doesn't
+   *          depend on the positions not solved yet.
+   * @param endgame - the endgame being generated.
+   * @param entries - the entries of the table being generated.
+   * @param tables - the tables already generated.
+   * @param b - the board.
+   * @param side - the side to move.
+   * @param result - output argument receiving the value of the
+   *                 position.
+   * @param missing - set in case a position is not available in
+   *                  the tables already generated.
+   * @return - `true` if the position is solved.
+   */
+  bool
+  expand(const chess::ai::Endgame& endgame,
+         const Entries& entries,
+         const chess::ai::Tablebase& tables,
+         const chess::Board& b,
+         const chess::Color& side,
+         chess::ai::TablebaseResult& result,
+         std::atomic<bool>& missing)
+  {
+    chess::ai::MoveList moves = chess::ai::generate(side, b);
+    if (moves.empty()) {
+      result = chess::ai::TablebaseResult{b.computeCheck(side) ? -1 : 0, 0u};
+      return true;
+    }
+
+    // Positions not solved yet are further from the mate than
+    // all the solved ones, so the fastest win found is exact
+    // whenever it is short enough to matter for this pass.
+    bool win = false, draw = false, known = true;
+    unsigned fastest = TABLEBASE_MAX_PLIES, slowest = 0u;
+
+    for (unsigned id = 0u ; id < moves.size() ; ++id) {
+      chess::Board c(b);
+      chess::UndoRecord r;
+      chess::ai::TablebaseResult child;
+
+      c.makeMove(moves[id].start, moves[id].end, moves[id].promotion, r);
+      if (!lookup(endgame, entries, tables, c, chess::oppositeColor(side), moves[id], child, missing)) {
+        known = false;
+        continue;
+      }
+
+      if (child.outcome < 0) {
+        win = true;
+        fastest = std::min(fastest, child.plies);
+      }
+      else if (child.outcome == 0) {
+        draw = true;
+      }
+      else {
+        slowest = std::max(slowest, child.plies);
+      }
+    }
+
+    if (win) {
+      result = chess::ai::TablebaseResult{1, fastest + 1u};
+      return true;
+    }
+    if (!known) {
+      return false;
+    }
+
+    result = (draw ? chess::ai::TablebaseResult{0, 0u} : chess::ai::TablebaseResult{-1, slowest + 1u});
+    return true;
+  }
+
+  /**
+   * @brief - Fetch the value of the position reached after a move,
+   *          either in the table being generated or in the tables
+   *          already available for captures and promotions.
+   * @param endgame - the endgame being generated.
+   * @param entries - the entries of the table being generated.
+   * @param tables - the tables already generated.
+   * @param b - the board after the move.
+   * @param side - the side to move after the move.
+   * @param m - the move.
+   * @param result - output argument receiving the value of the
+   *                 position.
+   * @param missing - set in case the position is not available
+   *                  in the tables already generated.
+   * @return - `true` if the position is solved.
+   */
+  bool
+  lookup(const chess::ai::Endgame& endgame,
+         const Entries& entries,
+         const chess::ai::Tablebase& tables,
+         const chess::Board& b,
+         const chess::Color& side,
+         const chess::ai::Move& m,
+         chess::ai::TablebaseResult& result,
+         std::atomic<bool>& missing)
+  {
+    if (m.captured.valid() || m.promotion != chess::Type::None) {
+      if (!tables.probe(b, side, result)) {
+        missing.store(true, std::memory_order_relaxed);
+        return false;
+      }
+
+      return true;
+    }
+
+    // The entries ignore en passant: after a double push which
+    // can be captured this way, the position is evaluated from
+    // its moves, the capture leading to the tables already
+    // generated.
+    chess::Bitboard ep = b.enPassant();
+    bool passant =
+      m.piece.pawn() &&
+      std::abs(m.end.y() - m.start.y()) == 2 &&
+      ep != 0u &&
+      (chess::bitboard::pawnAttacks(chess::oppositeColor(side), chess::bitboard::first(ep)) & b.bitboard(side, chess::Type::Pawn)) != 0u;
+
+    if (passant) {
+      return expand(endgame, entries, tables, b, side, result, missing);
+    }
+
+    std::uint8_t entry = entries[endgame.index(b, side, false)].load(std::memory_order_relaxed);
+    if (entry == TABLEBASE_UNKNOWN) {
+      return false;
+    }
+
+    result = chess::ai::Tablebase::decode(entry);
+    return true;
+  }
+
+  /**
+   * @brief - Generate the table of an endgame and write it to the
+   *          output folder.
+   * @param logger - the logger to use.
+   * @param endgame - the endgame.
+   * @param directory - the output folder, which should contain
+   *                    the tables reached by captures and
+   *                    promotions.
+   * @param threads - the number of threads.
+   */
+  void
+  generate(utils::log::PrefixedLogger& logger,
+           const chess::ai::Endgame& endgame,
+           const std::string& directory,
+           unsigned threads)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    chess::ai::Tablebase tables(directory);
+
+    std::size_t size = endgame.size();
+    Entries entries(new std::atomic<std::uint8_t>[size]);
+
+    std::atomic<bool> missing(false);
+    std::atomic<unsigned> longest(0u);
+
+    // Mark the illegal positions, the mates and the stalemates.
+    // The longest distance to mate reached through a capture or
+    // a promotion tells how many passes are needed at least.
+    parallel(
+      threads,
+      size,
+      [&](chess::Board& b, std::size_t id) {
+        chess::Color side;
+        std::uint8_t entry = TABLEBASE_ILLEGAL;
+
+        if (endgame.decode(id, b, side) && !b.computeCheck(chess::oppositeColor(side))) {
+          chess::ai::MoveList moves = chess::ai::generate(side, b);
+
+          if (moves.empty()) {
+            entry = (b.computeCheck(side) ? chess::ai::Tablebase::encode(0u) : TABLEBASE_DRAW);
+          }
+          else {
+            entry = TABLEBASE_UNKNOWN;
+          }
+
+          for (unsigned m = 0u ; m < moves.size() ; ++m) {
+            if (!moves[m].captured.valid() && moves[m].promotion == chess::Type::None) {
+              continue;
+            }
+
+            chess::ai::TablebaseResult result;
+            chess::UndoRecord r;
+
+            b.makeMove(moves[m].start, moves[m].end, moves[m].promotion, r);
+            bool known = tables.probe(b, chess::oppositeColor(side), result);
+            b.unmakeMove(r);
+
+            if (!known) {
+              missing.store(true, std::memory_order_relaxed);
+              continue;
+            }
+
+            unsigned plies = result.plies + 1u;
+            unsigned current = longest.load(std::memory_order_relaxed);
+            while (plies > current && !longest.compare_exchange_weak(current, plies)) {}
+          }
+        }
+
+        entries[id].store(entry, std::memory_order_relaxed);
+      }
+    );
+
+    if (missing.load()) {
+      throw utils::CoreException(
+        "Failed to generate " + endgame.name(),
+        "tbgen",
+        "chess",
+        "Tables reached by captures or promotions are missing"
+      );
+    }
+
+    // A position wins in an odd number of plies if one of its
+    // moves leads to a position lost one ply earlier, and loses
+    // in an even number of plies when all its moves lead to a
+    // position won at most one ply earlier.
+    unsigned quiet = 0u;
+    unsigned plies = 1u;
+
+    while (plies <= TABLEBASE_MAX_PLIES && (quiet < 2u || plies <= longest.load() + 1u)) {
+      std::atomic<std::size_t> solved(0u);
+      bool win = (plies % 2u == 1u);
+
+      parallel(
+        threads,
+        size,
+        [&](chess::Board& b, std::size_t id) {
+          if (entries[id].load(std::memory_order_relaxed) != TABLEBASE_UNKNOWN) {
+            return;
+          }
+
+          chess::Color side;
+          endgame.decode(id, b, side);
+
+          chess::Color o = chess::oppositeColor(side);
+          chess::ai::MoveList moves = chess::ai::generate(side, b);
+          bool done = !win;
+
+          for (unsigned m = 0u ; m < moves.size() ; ++m) {
+            chess::ai::TablebaseResult result;
+            chess::UndoRecord r;
+
+            b.makeMove(moves[m].start, moves[m].end, moves[m].promotion, r);
+            bool known = lookup(endgame, entries, tables, b, o, moves[m], result, missing);
+            b.unmakeMove(r);
+
+            if (win && known && result.outcome < 0 && result.plies == plies - 1u) {
+              done = true;
+              break;
+            }
+            if (!win && (!known || result.outcome <= 0 || result.plies > plies - 1u)) {
+              done = false;
+              break;
+            }
+          }
+
+          if (done) {
+            entries[id].store(chess::ai::Tablebase::encode(plies), std::memory_order_relaxed);
+            solved.fetch_add(1u, std::memory_order_relaxed);
+          }
+        }
+      );
+
+      quiet = (solved.load() == 0u ? quiet + 1u : 0u);
+      ++plies;
+    }
+
+    // Write the table: the positions not solved are draws.
+    std::vector<std::uint8_t> data(size);
+    std::size_t wins = 0u, losses = 0u, draws = 0u;
+    unsigned deepest = 0u;
+
+    for (std::size_t id = 0u ; id < size ; ++id) {
+      std::uint8_t entry = entries[id].load(std::memory_order_relaxed);
+
+      if (entry == TABLEBASE_UNKNOWN) {
+        entry = TABLEBASE_DRAW;
+      }
+
+      if (entry == TABLEBASE_DRAW) {
+        ++draws;
+      }
+      else if (entry != TABLEBASE_ILLEGAL) {
+        chess::ai::TablebaseResult result = chess::ai::Tablebase::decode(entry);
+        if (result.outcome > 0) {
+          ++wins;
+        }
+        else {
+          ++losses;
+        }
+
+        deepest = std::max(deepest, result.plies);
+      }
+
+      data[id] = entry;
+    }
+
+    std::string file = directory + "/" + endgame.name() + TABLEBASE_EXTENSION;
+    std::ofstream out(file, std::ios::binary);
+    out.write(TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC) - 1u);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if (!out.good()) {
+      throw utils::CoreException("Failed to write " + endgame.name(), "tbgen", "chess", "Unable to write \"" + file + "\"");
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    logger.notice(
+      endgame.name() + ": " + std::to_string(size) + " position(s), " +
+      std::to_string(wins) + " win(s), " + std::to_string(losses) + " loss(es), " + std::to_string(draws) + " draw(s), " +
+      "longest mate in " + std::to_string(deepest) + " plies, " + std::to_string(plies - 1u) + " pass(es) in " +
+      std::to_string(static_cast<int>(elapsed.count() * 1000.0)) + "ms"
+    );
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("chess", "tbgen");
+  utils::log::Locator::provide(&raw);
+
+  bool success = true;
+
+  try {
+    std::string directory = DEFAULT_DIRECTORY;
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::string name;
+    bool force = false;
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg = argv[id];
+
+      if (arg == "-o" && id + 1 < argc) {
+        directory = argv[++id];
+      }
+      else if (arg == "-t" && id + 1 < argc) {
+        threads = std::max(static_cast<unsigned>(std::stoul(argv[++id])), 1u);
+      }
+      else if (arg == "-e" && id + 1 < argc) {
+        name = argv[++id];
+      }
+      else if (arg == "-f") {
+        force = true;
+      }
+      else {
+        logger.error("Unknown argument \"" + arg + "\"");
+        logger.notice("Usage: " + std::string(argv[0]) + " [-o folder] [-t threads] [-e endgame] [-f]");
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::filesystem::create_directories(directory);
+
+    std::vector<chess::ai::Endgame> endgames = chess::ai::Endgame::all();
+    bool found = false;
+
+    for (unsigned id = 0u ; id < endgames.size() ; ++id) {
+      const chess::ai::Endgame& e = endgames[id];
+      if (!name.empty() && e.name() != name) {
+        continue;
+      }
+
+      found = true;
+
+      std::string file = directory + "/" + e.name() + TABLEBASE_EXTENSION;
+      if (!force && std::filesystem::exists(file)) {
+        logger.info("Keeping existing table for " + e.name());
+        continue;
+      }
+
+      logger.info("Generating " + e.name() + " with " + std::to_string(threads) + " thread(s)");
+      generate(logger, e, directory, threads);
+    }
+
+    if (!found) {
+      logger.error("Unknown endgame \"" + name + "\"");
+      success = false;
+    }
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while generating tables", e.what());
+    success = false;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while generating tables", e.what());
+    success = false;
+  }
+  catch (...) {
+    logger.error("Unexpected error while generating tables");
+    success = false;
+  }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
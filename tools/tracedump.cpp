@@ -0,0 +1,248 @@
+/**
+ * @brief - Decode the events recorded by the search of the AI
+ *          when tracing is enabled (see the `T` key in the game).
+ *          Each thread of the search records when it enters a
+ *          node, the moves it tries, the moves exceeding beta and
+ *          the score returned by each node: the events are kept
+ *          in a ring buffer so only the most recent ones of long
+ *          searches are available.
+ *
+ *          Usage:
+ *            chess_tracedump [-i file] [-t thread] [-j]
+ *              prints the events of the input trace (or the one
+ *              saved by the game by default) as text, indented by
+ *              the distance to the root, or as JSON. The events
+ *              can be restricted to a single thread.
+ */
+
+# include <iostream>
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "Trace.hh"
+
+/// @brief - The file read by default, where the game saves the
+/// trace of the last search.
+# define DEFAULT_FILE "data/trace.bin"
+
+namespace {
+
+  /**
+   * @brief - Returns the name of an event.
+   * @param event - the event.
+   * @return - the name of the event.
+   */
+  const char*
+  eventToString(const chess::ai::TraceEvent& event) noexcept {
+    switch (event) {
+      case chess::ai::TraceEvent::Enter:
+        return "enter";
+      case chess::ai::TraceEvent::Move:
+        return "move";
+      case chess::ai::TraceEvent::Cutoff:
+        return "cutoff";
+      case chess::ai::TraceEvent::Return:
+        return "return";
+      default:
+        return "unknown";
+    }
+  }
+
+  /**
+   * @brief - Convert a move packed in a record to its algebraic
+   *          notation, such as `e7e8q`.
+   * @param move - the packed move.
+   * @return - the move as a string.
+   */
+  std::string
+  moveToString(std::uint16_t move) noexcept {
+    unsigned start = move & 0x3Fu;
+    unsigned end = (move >> 6u) & 0x3Fu;
+    unsigned promotion = (move >> 12u) & 0xFu;
+
+    std::string out;
+    out += static_cast<char>('a' + start % 8u);
+    out += static_cast<char>('1' + start / 8u);
+    out += static_cast<char>('a' + end % 8u);
+    out += static_cast<char>('1' + end / 8u);
+
+    const char* PROMOTIONS = "pnbrqk";
+    if (promotion < static_cast<unsigned>(chess::Type::None)) {
+      out += PROMOTIONS[promotion];
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - Format the lowest bits of a key in hexadecimal.
+   * @param key - the key.
+   * @return - the key as a string.
+   */
+  std::string
+  keyToString(std::uint32_t key) noexcept {
+    const char* DIGITS = "0123456789abcdef";
+
+    std::string out = "0x";
+    for (int shift = 28 ; shift >= 0 ; shift -= 4) {
+      out += DIGITS[(key >> shift) & 0xFu];
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - Print the events of a thread as text.
+   * @param t - the events of the thread.
+   */
+  void
+  printText(const chess::ai::ThreadTrace& t) {
+    std::cout << "Thread " << t.thread << ": " << t.events << " event(s), " << t.records.size() << " kept" << std::endl;
+
+    for (unsigned id = 0u ; id < t.records.size() ; ++id) {
+      const chess::ai::TraceRecord& r = t.records[id];
+
+      std::cout << "[" << static_cast<unsigned>(r.ply) << "] " << std::string(2u * r.ply, ' ') << eventToString(r.event);
+
+      switch (r.event) {
+        case chess::ai::TraceEvent::Enter:
+          std::cout << " [" << r.alpha << ", " << r.beta << "] remaining " << static_cast<unsigned>(r.remaining);
+          std::cout << " key " << keyToString(r.key);
+          break;
+        case chess::ai::TraceEvent::Move:
+          std::cout << " #" << static_cast<unsigned>(r.index) << " " << moveToString(r.move);
+          std::cout << " [" << r.alpha << ", " << r.beta << "]";
+          break;
+        case chess::ai::TraceEvent::Cutoff:
+          std::cout << " #" << static_cast<unsigned>(r.index) << " " << moveToString(r.move) << " score " << r.score;
+          break;
+        case chess::ai::TraceEvent::Return:
+        default:
+          std::cout << " " << r.score;
+          break;
+      }
+
+      std::cout << std::endl;
+    }
+  }
+
+  /**
+   * @brief - Print the events of a thread as a JSON object.
+   * @param t - the events of the thread.
+   */
+  void
+  printJson(const chess::ai::ThreadTrace& t) {
+    std::cout << "{\"thread\": " << t.thread << ", \"events\": " << t.events << ", \"records\": [";
+
+    for (unsigned id = 0u ; id < t.records.size() ; ++id) {
+      const chess::ai::TraceRecord& r = t.records[id];
+
+      std::cout << (id > 0u ? "," : "") << "\n  {\"event\": \"" << eventToString(r.event) << "\"";
+      std::cout << ", \"ply\": " << static_cast<unsigned>(r.ply);
+      std::cout << ", \"remaining\": " << static_cast<unsigned>(r.remaining);
+
+      switch (r.event) {
+        case chess::ai::TraceEvent::Enter:
+          std::cout << ", \"alpha\": " << r.alpha << ", \"beta\": " << r.beta;
+          std::cout << ", \"key\": \"" << keyToString(r.key) << "\"";
+          break;
+        case chess::ai::TraceEvent::Move:
+          std::cout << ", \"index\": " << static_cast<unsigned>(r.index) << ", \"move\": \"" << moveToString(r.move) << "\"";
+          std::cout << ", \"alpha\": " << r.alpha << ", \"beta\": " << r.beta;
+          break;
+        case chess::ai::TraceEvent::Cutoff:
+          std::cout << ", \"index\": " << static_cast<unsigned>(r.index) << ", \"move\": \"" << moveToString(r.move) << "\"";
+          std::cout << ", \"score\": " << r.score;
+          break;
+        case chess::ai::TraceEvent::Return:
+        default:
+          std::cout << ", \"score\": " << r.score;
+          break;
+      }
+
+      std::cout << "}";
+    }
+
+    std::cout << "\n]}";
+  }
+
+}
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("chess", "tracedump");
+  utils::log::Locator::provide(&raw);
+
+  bool success = true;
+
+  try {
+    std::string file = DEFAULT_FILE;
+    int thread = -1;
+    bool json = false;
+
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg = argv[id];
+
+      if (arg == "-i" && id + 1 < argc) {
+        file = argv[++id];
+      }
+      else if (arg == "-t" && id + 1 < argc) {
+        thread = std::stoi(argv[++id]);
+      }
+      else if (arg == "-j") {
+        json = true;
+      }
+      else {
+        logger.error("Unknown argument \"" + arg + "\"");
+        logger.notice("Usage: " + std::string(argv[0]) + " [-i file] [-t thread] [-j]");
+        return EXIT_FAILURE;
+      }
+    }
+
+    chess::ai::TraceFile trace(file);
+    std::vector<chess::ai::ThreadTrace> threads = trace.load();
+
+    if (json) {
+      std::cout << "{\"threads\": [";
+    }
+
+    bool first = true;
+    for (unsigned id = 0u ; id < threads.size() ; ++id) {
+      if (thread >= 0 && threads[id].thread != static_cast<unsigned>(thread)) {
+        continue;
+      }
+
+      if (json) {
+        std::cout << (first ? "\n" : ",\n");
+        printJson(threads[id]);
+      }
+      else {
+        printText(threads[id]);
+      }
+
+      first = false;
+    }
+
+    if (json) {
+      std::cout << "\n]}" << std::endl;
+    }
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while decoding trace", e.what());
+    success = false;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while decoding trace", e.what());
+    success = false;
+  }
+  catch (...) {
+    logger.error("Unexpected error while decoding trace");
+    success = false;
+  }
+
+  return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}